@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * SHA-256 block transform using the ARMv8 Crypto Extensions
+ *
+ * Overrides the generic sha256_process() from lib/sha256.c, so every user
+ * of sha256_update() (the hash command, FIT image verification, the
+ * software hash driver) picks it up.
+ */
+
+#include <common.h>
+#include <linux/kernel.h>
+#include <u-boot/sha256.h>
+
+#define ID_AA64ISAR0_SHA2_SHIFT		12
+#define ID_AA64ISAR0_SHA2_MASK		0xf
+
+void sha256_ce_transform(uint32_t state[8], const uint8_t *src,
+			 unsigned int blocks);
+
+static bool sha256_ce_available(void)
+{
+	u64 isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return (isar0 >> ID_AA64ISAR0_SHA2_SHIFT) & ID_AA64ISAR0_SHA2_MASK;
+}
+
+void sha256_process(sha256_context *ctx, const uint8_t *data,
+		    unsigned int blocks)
+{
+	if (!blocks)
+		return;
+
+	/*
+	 * The input is loaded as 32-bit lanes, which must be aligned while
+	 * the caches (and so Normal memory attributes) are still off.
+	 */
+	if (sha256_ce_available() && IS_ALIGNED((uintptr_t)data, 4))
+		sha256_ce_transform(ctx->state, data, blocks);
+	else
+		sha256_process_generic(ctx, data, blocks);
+}
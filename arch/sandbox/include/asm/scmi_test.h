@@ -15,11 +15,13 @@ struct sandbox_scmi_service;
  * @id:		Identifier of the clock used in the SCMI protocol
  * @enabled:	Clock state: true if enabled, false if disabled
  * @rate:	Clock rate in Hertz
+ * @fixed:	Clock has the single rate @rate, which cannot be set
  */
 struct sandbox_scmi_clk {
 	uint id;
 	bool enabled;
 	ulong rate;
+	bool fixed;
 };
 
 /**
@@ -53,6 +55,9 @@ struct sandbox_scmi_voltd {
  * @reset_count: Simulated reset domains array size
  * @voltd:	 Simulated voltage domains (regulators)
  * @voltd_count: Simulated voltage domains array size
+ * @msg_count:	Number of messages processed since the agent was probed
+ * @doorbell_count: Number of exchanges with the agent since it was probed,
+ *		 each carrying one or more messages
  */
 struct sandbox_scmi_agent {
 	uint idx;
@@ -62,6 +67,8 @@ struct sandbox_scmi_agent {
 	size_t reset_count;
 	struct sandbox_scmi_voltd *voltd;
 	size_t voltd_count;
+	uint msg_count;
+	uint doorbell_count;
 };
 
 /**
@@ -13,6 +13,8 @@
 #include <part.h>
 #include <sparse_format.h>
 #include <image-sparse.h>
+#include <time.h>
+#include <linux/math64.h>
 
 static int curr_device = -1;
 
@@ -362,6 +364,54 @@ static int do_mmc_read(struct cmd_tbl *cmdtp, int flag,
 	return (n == cnt) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
 }
 
+#if CONFIG_IS_ENABLED(CMD_MMC_BENCH)
+static int do_mmc_bench(struct cmd_tbl *cmdtp, int flag,
+			int argc, char *const argv[])
+{
+	struct blk_desc *desc;
+	struct mmc *mmc;
+	u32 blk, cnt, req, done, n, reqs = 0;
+	ulong start, elapsed;
+	void *addr;
+
+	if (argc != 4 && argc != 5)
+		return CMD_RET_USAGE;
+
+	addr = (void *)hextoul(argv[1], NULL);
+	blk = hextoul(argv[2], NULL);
+	cnt = hextoul(argv[3], NULL);
+	req = argc == 5 ? hextoul(argv[4], NULL) : cnt;
+	if (!cnt || !req)
+		return CMD_RET_USAGE;
+
+	mmc = init_mmc_device(curr_device, false);
+	if (!mmc)
+		return CMD_RET_FAILURE;
+	desc = mmc_get_blk_desc(mmc);
+
+	printf("\nMMC bench: dev # %d, block # %d, count %d, %d blocks per read ... ",
+	       curr_device, blk, cnt, req);
+
+	/* Every request reads into the same buffer, which needs req blocks */
+	start = timer_get_us();
+	for (done = 0; done < cnt; done += n, reqs++) {
+		n = min(req, cnt - done);
+		if (blk_dread(desc, blk + done, n, addr) != n) {
+			printf("read error at block %d\n", blk + done);
+			return CMD_RET_FAILURE;
+		}
+	}
+	elapsed = max(timer_get_us() - start, 1UL);
+
+	printf("%lu us\n", elapsed);
+	printf("%llu KiB/s, %llu reads/s\n",
+	       div_u64((u64)cnt * desc->blksz * 1000000 / 1024, elapsed),
+	       div_u64((u64)reqs * 1000000, elapsed));
+
+	return CMD_RET_SUCCESS;
+}
+#endif
+
 #if CONFIG_IS_ENABLED(CMD_MMC_SWRITE)
 static lbaint_t mmc_sparse_write(struct sparse_storage *info, lbaint_t blk,
 				 lbaint_t blkcnt, const void *buffer)
@@ -377,6 +427,14 @@ static lbaint_t mmc_sparse_reserve(struct sparse_storage *info,
 	return blkcnt;
 }
 
+static lbaint_t mmc_sparse_erase(struct sparse_storage *info, lbaint_t blk,
+				 lbaint_t blkcnt)
+{
+	struct blk_desc *dev_desc = info->priv;
+
+	return blk_derase(dev_desc, blk, blkcnt);
+}
+
 static int do_mmc_sparse_write(struct cmd_tbl *cmdtp, int flag,
 			       int argc, char *const argv[])
 {
@@ -385,15 +443,18 @@ static int do_mmc_sparse_write(struct cmd_tbl *cmdtp, int flag,
 	struct mmc *mmc;
 	char dest[11];
 	void *addr;
-	u32 blk;
+	u32 blk, cnt = 0;
+	int ret;
 
-	if (argc != 3)
+	if (argc != 3 && argc != 4)
 		return CMD_RET_USAGE;
 
 	addr = (void *)hextoul(argv[1], NULL);
 	blk = hextoul(argv[2], NULL);
+	if (argc == 4)
+		cnt = hextoul(argv[3], NULL);
 
-	if (!is_sparse_image(addr)) {
+	if (!is_sparse_image(addr) && !cnt) {
 		printf("Not a sparse image\n");
 		return CMD_RET_FAILURE;
 	}
@@ -417,13 +478,17 @@ static int do_mmc_sparse_write(struct cmd_tbl *cmdtp, int flag,
 	sparse.size = dev_desc->lba - blk;
 	sparse.write = mmc_sparse_write;
 	sparse.reserve = mmc_sparse_reserve;
+	sparse.erase_grp = mmc_erase_zero_grp(mmc);
+	sparse.erase = mmc_sparse_erase;
 	sparse.mssg = NULL;
 	sprintf(dest, "0x" LBAF, sparse.start * sparse.blksz);
 
-	if (write_sparse_image(&sparse, dest, addr, NULL))
-		return CMD_RET_FAILURE;
+	if (is_sparse_image(addr))
+		ret = write_sparse_image(&sparse, dest, addr, NULL);
 	else
-		return CMD_RET_SUCCESS;
+		ret = write_raw_image_sparse(&sparse, dest, addr, cnt, NULL);
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
 }
 #endif
 
@@ -1038,13 +1103,16 @@ static int do_mmc_boot_wp(struct cmd_tbl *cmdtp, int flag,
 static struct cmd_tbl cmd_mmc[] = {
 	U_BOOT_CMD_MKENT(info, 1, 0, do_mmcinfo, "", ""),
 	U_BOOT_CMD_MKENT(read, 4, 1, do_mmc_read, "", ""),
+#if CONFIG_IS_ENABLED(CMD_MMC_BENCH)
+	U_BOOT_CMD_MKENT(bench, 5, 0, do_mmc_bench, "", ""),
+#endif
 	U_BOOT_CMD_MKENT(wp, 1, 0, do_mmc_boot_wp, "", ""),
 #if CONFIG_IS_ENABLED(MMC_WRITE)
 	U_BOOT_CMD_MKENT(write, 4, 0, do_mmc_write, "", ""),
 	U_BOOT_CMD_MKENT(erase, 3, 0, do_mmc_erase, "", ""),
 #endif
 #if CONFIG_IS_ENABLED(CMD_MMC_SWRITE)
-	U_BOOT_CMD_MKENT(swrite, 3, 0, do_mmc_sparse_write, "", ""),
+	U_BOOT_CMD_MKENT(swrite, 4, 0, do_mmc_sparse_write, "", ""),
 #endif
 	U_BOOT_CMD_MKENT(rescan, 2, 1, do_mmc_rescan, "", ""),
 	U_BOOT_CMD_MKENT(part, 1, 1, do_mmc_part, "", ""),
@@ -1101,8 +1169,12 @@ U_BOOT_CMD(
 	"info - display info of the current MMC device\n"
 	"mmc read addr blk# cnt\n"
 	"mmc write addr blk# cnt\n"
+#if CONFIG_IS_ENABLED(CMD_MMC_BENCH)
+	"mmc bench addr blk# cnt [blocks per read] - time reads of blk#..blk#+cnt\n"
+#endif
 #if CONFIG_IS_ENABLED(CMD_MMC_SWRITE)
-	"mmc swrite addr blk#\n"
+	"mmc swrite addr blk# [cnt] - write an Android sparse image, or a raw\n"
+	"    image of cnt blocks, erasing its zeros where the card allows\n"
 #endif
 	"mmc erase blk# cnt\n"
 	"mmc rescan [mode]\n"
@@ -16,6 +16,8 @@
 #include <net.h>
 #include <net/udp.h>
 #include <net/sntp.h>
+#include <net/tftp.h>
+#include <part.h>
 
 static int netboot_common(enum proto_t, struct cmd_tbl *, int, char * const []);
 
@@ -34,22 +36,70 @@ U_BOOT_CMD(
 #endif
 
 #ifdef CONFIG_CMD_TFTPBOOT
+#ifdef CONFIG_TFTP_BLK_WRITE
+/* Handle 'tftpboot -w <interface> <dev[:part]> ...' */
+static int do_tftpb_blk(struct cmd_tbl *cmdtp, int flag, int argc,
+			char *const argv[])
+{
+	struct blk_desc *desc;
+	struct disk_partition info;
+	char *args[3];
+	int part, ret, i;
+
+	if (argc < 4 || argc > 3 + ARRAY_SIZE(args))
+		return CMD_RET_USAGE;
+
+	part = blk_get_device_part_str(argv[2], argv[3], &desc, &info, 1);
+	if (part < 0)
+		return CMD_RET_FAILURE;
+	if (tftp_set_blk_target(desc, info.start, info.size, part > 0))
+		return CMD_RET_FAILURE;
+
+	/* Drop the option so that netboot_common() sees the usual form */
+	args[0] = argv[0];
+	for (i = 4; i < argc; i++)
+		args[i - 3] = argv[i];
+
+	ret = netboot_common(TFTPGET, cmdtp, argc - 3, args);
+	tftp_set_blk_target(NULL, 0, 0, false);
+
+	return ret;
+}
+#endif
+
 int do_tftpb(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 {
 	int ret;
 
 	bootstage_mark_name(BOOTSTAGE_KERNELREAD_START, "tftp_start");
-	ret = netboot_common(TFTPGET, cmdtp, argc, argv);
+#ifdef CONFIG_TFTP_BLK_WRITE
+	if (argc > 1 && !strcmp(argv[1], "-w"))
+		ret = do_tftpb_blk(cmdtp, flag, argc, argv);
+	else
+#endif
+		ret = netboot_common(TFTPGET, cmdtp, argc, argv);
 	bootstage_mark_name(BOOTSTAGE_KERNELREAD_STOP, "tftp_done");
 	return ret;
 }
 
+#ifdef CONFIG_TFTP_BLK_WRITE
+U_BOOT_CMD(
+	tftpboot,	6,	1,	do_tftpb,
+	"boot image via network using TFTP protocol",
+	"[loadAddress] [[hostIPaddr:]bootfilename]\n"
+	"tftpboot -w <interface> <dev[:part]> [loadAddress] [[hostIPaddr:]bootfilename]\n"
+	"    - write the file to a block device or partition while it is\n"
+	"      received, staging it at loadAddress. Use <dev>:0 for the whole\n"
+	"      device, a bare <dev> picks its first partition if it has any"
+);
+#else
 U_BOOT_CMD(
 	tftpboot,	3,	1,	do_tftpb,
 	"boot image via network using TFTP protocol",
 	"[loadAddress] [[hostIPaddr:]bootfilename]"
 );
 #endif
+#endif
 
 #ifdef CONFIG_CMD_TFTPPUT
 static int do_tftpput(struct cmd_tbl *cmdtp, int flag, int argc,
@@ -550,6 +550,18 @@ static int do_spi_flash_test(int argc, char *const argv[])
 }
 #endif /* CONFIG_CMD_SF_TEST */
 
+#ifdef CONFIG_SPI_FLASH_READ_CACHE
+static int do_spi_flash_cache(int argc, char *const argv[])
+{
+	ulong hits, misses;
+
+	spi_flash_cache_get_stats(&hits, &misses);
+	printf("SPI flash read cache: %lu hits, %lu misses\n", hits, misses);
+
+	return 0;
+}
+#endif
+
 static int do_spi_flash(struct cmd_tbl *cmdtp, int flag, int argc,
 			char *const argv[])
 {
@@ -585,6 +597,10 @@ static int do_spi_flash(struct cmd_tbl *cmdtp, int flag, int argc,
 #ifdef CONFIG_CMD_SF_TEST
 	else if (!strcmp(cmd, "test"))
 		ret = do_spi_flash_test(argc, argv);
+#endif
+#ifdef CONFIG_SPI_FLASH_READ_CACHE
+	else if (!strcmp(cmd, "cache"))
+		ret = do_spi_flash_cache(argc, argv);
 #endif
 	else
 		ret = -1;
@@ -604,6 +620,13 @@ usage:
 #define SF_TEST_HELP
 #endif
 
+#ifdef CONFIG_SPI_FLASH_READ_CACHE
+#define SF_CACHE_HELP "\nsf cache			" \
+		"- show read cache hit and miss counts"
+#else
+#define SF_CACHE_HELP
+#endif
+
 U_BOOT_CMD(
 	sf,	5,	1,	do_spi_flash,
 	"SPI flash sub-system",
@@ -624,4 +647,5 @@ U_BOOT_CMD(
 	"sf protect lock/unlock sector len	- protect/unprotect 'len' bytes starting\n"
 	"					  at address 'sector'\n"
 	SF_TEST_HELP
+	SF_CACHE_HELP
 );
@@ -5,18 +5,24 @@
  */
 
 #include <common.h>
+#include <abuf.h>
 #include <errno.h>
 #include <fpga.h>
 #include <gzip.h>
+#include <hash.h>
 #include <image.h>
 #include <log.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <memalign.h>
 #include <spl.h>
 #include <sysinfo.h>
+#include <watchdog.h>
 #include <asm/cache.h>
 #include <asm/global_data.h>
 #include <linux/libfdt.h>
+#include <linux/zstd.h>
+#include <u-boot/zlib.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -218,6 +224,383 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
 	return (data_size + info->bl_len - 1) / info->bl_len;
 }
 
+/* Return true if SPL decompresses images of type @image_comp */
+static bool spl_fit_decompress(uint8_t image_comp)
+{
+	return (IS_ENABLED(CONFIG_SPL_GZIP) && image_comp == IH_COMP_GZIP) ||
+	       (IS_ENABLED(CONFIG_SPL_ZSTD) && image_comp == IH_COMP_ZSTD);
+}
+
+#if CONFIG_IS_ENABLED(LOAD_FIT_DIRECT)
+/*
+ * Read the unit at index @block of the image area into @bounce. For a file
+ * system only @size bytes are read, since the file may end within the unit.
+ */
+static int spl_fit_read_bounce(struct spl_load_info *info, ulong sector,
+			       ulong unit, ulong block, ulong size,
+			       void *bounce)
+{
+	if (info->filename)
+		return info->read(info, sector + block * unit, size,
+				  bounce) == size ? 0 : -EIO;
+
+	return info->read(info, sector + block, 1, bounce) == 1 ? 0 : -EIO;
+}
+
+/**
+ * spl_fit_read_direct() - read external data straight to its load address
+ *
+ * Only the partial units (sectors, or ARCH_DMA_MINALIGN bytes for a file
+ * system) at the head and tail of the data go through a bounce buffer. The
+ * whole units in between are read directly into place, which needs the
+ * destination to be aligned to match them.
+ *
+ * @info:	Device to load data from
+ * @sector:	Start sector of the FIT image on the device
+ * @offset:	Offset of the image data from @sector
+ * @length:	Size of the image data
+ * @dst:	Where to place the data
+ * Return:	0 if OK, -EAGAIN if @dst is not suitably aligned, other -ve on
+ *		error
+ */
+static int spl_fit_read_direct(struct spl_load_info *info, ulong sector,
+			       int offset, size_t length, void *dst)
+{
+	ulong unit = info->filename ? ARCH_DMA_MINALIGN : info->bl_len;
+	ulong block = offset / unit;
+	ulong overhead = offset % unit;
+	ulong head = overhead ? min_t(ulong, unit - overhead, length) : 0;
+	ulong count = (length - head) / unit;
+	ulong tail = length - head - count * unit;
+	void *bounce = NULL;
+	int ret;
+
+	if (!IS_ALIGNED((ulong)dst + head, ARCH_DMA_MINALIGN))
+		return -EAGAIN;
+
+	if (head || tail) {
+		bounce = malloc_cache_aligned(unit);
+		if (!bounce)
+			return -EAGAIN;
+	}
+
+	if (head) {
+		ret = spl_fit_read_bounce(info, sector, unit, block,
+					  overhead + head, bounce);
+		if (ret)
+			goto out;
+		memcpy(dst, bounce + overhead, head);
+		block++;
+	}
+
+	if (count) {
+		ulong n = info->filename ? count * unit : count;
+
+		if (info->read(info, sector + (info->filename ?
+					       block * unit : block),
+			       n, dst + head) != n) {
+			ret = -EIO;
+			goto out;
+		}
+	}
+
+	if (tail) {
+		ret = spl_fit_read_bounce(info, sector, unit, block + count,
+					  tail, bounce);
+		if (ret)
+			goto out;
+		memcpy(dst + head + count * unit, bounce, tail);
+	}
+
+	debug("Direct data: dst=%p, head=%lx, tail=%lx\n", dst, head, tail);
+	ret = 0;
+out:
+	free(bounce);
+
+	return ret;
+}
+#endif /* LOAD_FIT_DIRECT */
+
+#if CONFIG_IS_ENABLED(LOAD_FIT_STREAM)
+#define SPL_FIT_STREAM_MAX_HASHES	4
+
+struct spl_fit_stream_hash {
+	int noffset;
+	struct hash_algo *algo;
+	void *ctx;
+};
+
+struct spl_fit_stream {
+	struct spl_fit_stream_hash hash[SPL_FIT_STREAM_MAX_HASHES];
+	int nr_hashes;
+	z_stream zs;
+	bool zs_active;
+	bool zs_end;
+};
+
+/*
+ * Finish every hash context; if @fit is not NULL also check the results
+ * against the values in the FIT.
+ */
+static int spl_fit_stream_hash_finish(struct spl_fit_stream *st,
+				      const void *fit, int node)
+{
+	uint8_t value[FIT_MAX_HASH_LEN];
+	uint8_t *fit_value;
+	int fit_value_len;
+	int i, ret = 0;
+
+	for (i = 0; i < st->nr_hashes; i++) {
+		struct spl_fit_stream_hash *hash = &st->hash[i];
+
+		if (hash->algo->hash_finish(hash->algo, hash->ctx, value,
+					    sizeof(value)) && fit) {
+			ret = -EIO;
+			continue;
+		}
+		if (!fit || ret)
+			continue;
+
+		printf("%s", hash->algo->name);
+		if (fit_image_hash_get_value(fit, hash->noffset, &fit_value,
+					     &fit_value_len) ||
+		    fit_value_len != hash->algo->digest_size ||
+		    memcmp(value, fit_value, fit_value_len)) {
+			printf(" error!\nBad hash value for '%s' hash node in '%s' image node\n",
+			       fit_get_name(fit, hash->noffset, NULL),
+			       fit_get_name(fit, node, NULL));
+			ret = -EPERM;
+			continue;
+		}
+		puts("+ ");
+	}
+	st->nr_hashes = 0;
+
+	return ret;
+}
+
+/*
+ * Set up a progressive hash for each hash node of the image. Images that
+ * carry their own signature need the whole image in memory, as do hash
+ * nodes this cannot handle; -EAGAIN sends those down the normal path.
+ */
+static int spl_fit_stream_hash_init(struct spl_fit_stream *st,
+				    const void *fit, int node)
+{
+	int noffset;
+
+	fdt_for_each_subnode(noffset, fit, node) {
+		const char *name = fit_get_name(fit, noffset, NULL);
+		struct spl_fit_stream_hash *hash;
+		char *algo_name;
+
+		if (!strncmp(name, FIT_SIG_NODENAME, strlen(FIT_SIG_NODENAME)))
+			goto fallback;
+		if (strncmp(name, FIT_HASH_NODENAME, strlen(FIT_HASH_NODENAME)))
+			continue;
+
+		if (st->nr_hashes == SPL_FIT_STREAM_MAX_HASHES ||
+		    fdt_getprop(fit, noffset, FIT_IGNORE_PROP, NULL) ||
+		    fit_image_hash_get_algo(fit, noffset, &algo_name))
+			goto fallback;
+
+		hash = &st->hash[st->nr_hashes];
+		hash->noffset = noffset;
+		if (hash_lookup_algo(algo_name, &hash->algo) ||
+		    !hash->algo->hash_init ||
+		    hash->algo->hash_init(hash->algo, &hash->ctx))
+			goto fallback;
+		st->nr_hashes++;
+	}
+
+	return 0;
+
+fallback:
+	spl_fit_stream_hash_finish(st, NULL, node);
+	return -EAGAIN;
+}
+
+/* Feed one chunk of compressed data to the decompressor */
+static int spl_fit_stream_inflate(struct spl_fit_stream *st, void *load_ptr,
+				  uint8_t *data, size_t size)
+{
+	int offset = 0;
+	int r;
+
+	/* Whatever follows the deflate data is the gzip trailer */
+	if (st->zs_end)
+		return 0;
+
+	if (!st->zs_active) {
+		offset = gzip_parse_header(data, size);
+		if (offset < 0)
+			return -EIO;
+
+		st->zs.zalloc = gzalloc;
+		st->zs.zfree = gzfree;
+		if (inflateInit2(&st->zs, -MAX_WBITS) != Z_OK)
+			return -EIO;
+		st->zs.next_out = load_ptr;
+		st->zs.avail_out = CONFIG_SYS_BOOTM_LEN;
+		st->zs_active = true;
+	}
+
+	st->zs.next_in = data + offset;
+	st->zs.avail_in = size - offset;
+	do {
+		r = inflate(&st->zs, Z_NO_FLUSH);
+		if (r == Z_STREAM_END) {
+			st->zs_end = true;
+			return 0;
+		}
+		if (r != Z_OK) {
+			printf("Error: inflate() returned %d\n", r);
+			return -EIO;
+		}
+	} while (st->zs.avail_in);
+
+	return 0;
+}
+
+/**
+ * spl_fit_stream_image() - load external image data in chunks
+ *
+ * Reads CONFIG_SPL_LOAD_FIT_STREAM_CHUNK_SZ bytes at a time and feeds every
+ * chunk to the hashes and the decompressor while it is still in the cache,
+ * rather than making separate passes over the whole image. Uncompressed
+ * data which is suitably aligned on the medium is read straight to its
+ * load address, avoiding the copy from the read buffer.
+ *
+ * @info:	Device to load data from
+ * @sector:	Start sector of the FIT image on the device
+ * @fit:	FIT blob
+ * @node:	Image node
+ * @offset:	Offset of the image data from @sector
+ * @length:	Size of the image data, updated to the loaded size
+ * @load_addr:	Address to load the image to
+ * @image_comp:	Compression type of the image
+ * Return:	0 if OK, -EAGAIN if the image must be loaded the normal way,
+ *		other -ve on error
+ */
+static int spl_fit_stream_image(struct spl_load_info *info, ulong sector,
+				const void *fit, int node, int offset,
+				size_t *length, ulong load_addr,
+				uint8_t image_comp)
+{
+	ulong unit = info->filename ? 1 : info->bl_len;
+	ulong chunk = CONFIG_SPL_LOAD_FIT_STREAM_CHUNK_SZ / unit;
+	ulong start = sector + get_aligned_image_offset(info, offset);
+	ulong total = get_aligned_image_size(info, *length, offset);
+	ulong overhead = get_aligned_image_overhead(info, offset);
+	bool compressed = IS_ENABLED(CONFIG_SPL_GZIP) &&
+			  image_comp == IH_COMP_GZIP;
+	struct spl_fit_stream st = { .nr_hashes = 0 };
+	size_t left = *length;
+	void *load_ptr, *buf = NULL;
+	ulong pos, n;
+	int i, ret;
+
+	/* zstd needs a window-sized buffer to stream, decode it in one go */
+	if (IS_ENABLED(CONFIG_SPL_ZSTD) && image_comp == IH_COMP_ZSTD)
+		return -EAGAIN;
+
+	load_ptr = map_sysmem(load_addr, *length);
+	if (compressed || overhead ||
+	    !IS_ALIGNED((ulong)load_ptr, ARCH_DMA_MINALIGN)) {
+		/* Misaligned data is better placed without a full copy */
+		if (!compressed && CONFIG_IS_ENABLED(LOAD_FIT_DIRECT))
+			return -EAGAIN;
+		buf = malloc_cache_aligned(chunk * unit);
+		if (!buf)
+			return -EAGAIN;
+	}
+
+	if (CONFIG_IS_ENABLED(FIT_SIGNATURE)) {
+		int verify_all = 1;
+
+		ret = spl_fit_stream_hash_init(&st, fit, node);
+		if (ret)
+			goto out;
+
+		printf("## Checking hash(es) for Image %s ... ",
+		       fit_get_name(fit, node, NULL));
+		/* Fails if the image lacks a required signature */
+		if (FIT_IMAGE_ENABLE_VERIFY &&
+		    fit_image_verify_required_sigs(fit, node, NULL, 0,
+						   gd_fdt_blob(),
+						   &verify_all)) {
+			ret = -EPERM;
+			goto out;
+		}
+	}
+
+	debug("Streaming data: dst=%p, offset=%x, size=%lx%s\n", load_ptr,
+	      offset, (ulong)*length, buf ? "" : ", direct");
+
+	for (pos = 0; pos < total; pos += n) {
+		uint8_t *data = buf ? buf : load_ptr + pos * unit;
+		size_t size;
+
+		n = min(total - pos, chunk);
+		if (info->read(info, start + pos, n, data) != n) {
+			ret = -EIO;
+			goto out;
+		}
+
+		size = n * unit;
+		if (!pos) {
+			data += overhead;
+			size -= overhead;
+		}
+		size = min(size, left);
+
+		for (i = 0; i < st.nr_hashes; i++)
+			st.hash[i].algo->hash_update(st.hash[i].algo,
+						     st.hash[i].ctx, data,
+						     size, size == left);
+
+		if (compressed) {
+			ret = spl_fit_stream_inflate(&st, load_ptr, data, size);
+			if (ret) {
+				puts("Uncompressing error\n");
+				goto out;
+			}
+		} else if (buf) {
+			memcpy(load_ptr + *length - left, data, size);
+		}
+
+		left -= size;
+		WATCHDOG_RESET();
+	}
+
+	/* Truncated compressed data runs out before the end of the stream */
+	if (compressed && !st.zs_end) {
+		puts("Uncompressing error\n");
+		ret = -EIO;
+		goto out;
+	}
+
+	if (CONFIG_IS_ENABLED(FIT_SIGNATURE)) {
+		ret = spl_fit_stream_hash_finish(&st, fit, node);
+		if (ret)
+			goto out;
+		puts("OK\n");
+	}
+
+	if (compressed)
+		*length = st.zs.total_out;
+	ret = 0;
+
+out:
+	spl_fit_stream_hash_finish(&st, NULL, node);
+	if (st.zs_active)
+		inflateEnd(&st.zs);
+	free(buf);
+
+	return ret;
+}
+#endif /* LOAD_FIT_STREAM */
+
 /**
  * spl_load_fit_image(): load the image described in a certain FIT node
  * @info:	points to information about the device to load data from
@@ -258,7 +641,7 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 			debug("%s ", genimg_get_type_name(type));
 	}
 
-	if (IS_ENABLED(CONFIG_SPL_GZIP)) {
+	if (IS_ENABLED(CONFIG_SPL_GZIP) || IS_ENABLED(CONFIG_SPL_ZSTD)) {
 		fit_image_get_comp(fit, node, &image_comp);
 		debug("%s ", genimg_get_comp_name(image_comp));
 	}
@@ -281,25 +664,72 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 
 	if (external_data) {
 		void *src_ptr;
+		int __maybe_unused ret;
 
 		/* External data */
 		if (fit_image_get_data_size(fit, node, &len))
 			return -ENOENT;
-
-		src_ptr = map_sysmem(ALIGN(load_addr, ARCH_DMA_MINALIGN), len);
 		length = len;
 
-		overhead = get_aligned_image_overhead(info, offset);
-		nr_sectors = get_aligned_image_size(info, length, offset);
+#if CONFIG_IS_ENABLED(LOAD_FIT_STREAM)
+		if (!CONFIG_IS_ENABLED(FIT_IMAGE_POST_PROCESS)) {
+			ret = spl_fit_stream_image(info, sector, fit, node,
+						   offset, &length, load_addr,
+						   image_comp);
+			if (!ret)
+				goto loaded;
+			if (ret != -EAGAIN)
+				return ret;
+		}
+#endif
+
+		src = NULL;
+#if CONFIG_IS_ENABLED(LOAD_FIT_DIRECT)
+		if (!spl_fit_decompress(image_comp)) {
+			src_ptr = map_sysmem(load_addr, length);
+			ret = spl_fit_read_direct(info, sector, offset, length,
+						  src_ptr);
+			if (!ret)
+				src = src_ptr;
+			else if (ret != -EAGAIN)
+				return ret;
+		}
+#endif
 
-		if (info->read(info,
-			       sector + get_aligned_image_offset(info, offset),
-			       nr_sectors, src_ptr) != nr_sectors)
-			return -EIO;
+		if (!src) {
+			ulong stage = ALIGN(load_addr, ARCH_DMA_MINALIGN);
+
+			overhead = get_aligned_image_overhead(info, offset);
+			nr_sectors = get_aligned_image_size(info, length,
+							    offset);
+
+			/*
+			 * Compressed data is staged at CONFIG_SYS_LOAD_ADDR,
+			 * which must be clear of where it is unpacked to
+			 */
+			if (spl_fit_decompress(image_comp)) {
+				stage = ALIGN(CONFIG_SYS_LOAD_ADDR,
+					      ARCH_DMA_MINALIGN);
+				if (stage + nr_sectors * info->bl_len >
+				    load_addr &&
+				    stage < load_addr + CONFIG_SYS_BOOTM_LEN) {
+					printf("Compressed image at %lx overlaps its load address %lx\n",
+					       stage, load_addr);
+					return -EINVAL;
+				}
+			}
+			src_ptr = map_sysmem(stage, len);
+
+			if (info->read(info,
+				       sector + get_aligned_image_offset(info,
+									 offset),
+				       nr_sectors, src_ptr) != nr_sectors)
+				return -EIO;
+			src = src_ptr + overhead;
+		}
 
 		debug("External data: dst=%p, offset=%x, size=%lx\n",
-		      src_ptr, offset, (unsigned long)length);
-		src = src_ptr + overhead;
+		      src, offset, (unsigned long)length);
 	} else {
 		/* Embedded data */
 		if (fit_image_get_data(fit, node, &data, &length)) {
@@ -330,10 +760,25 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 			return -EIO;
 		}
 		length = size;
-	} else {
+	} else if (IS_ENABLED(CONFIG_SPL_ZSTD) && image_comp == IH_COMP_ZSTD) {
+		struct abuf in, out;
+		int ret;
+
+		abuf_init_set(&in, src, length);
+		abuf_init_set(&out, load_ptr, CONFIG_SYS_BOOTM_LEN);
+		ret = zstd_decompress(&in, &out);
+		if (ret < 0) {
+			puts("Uncompressing error\n");
+			return -EIO;
+		}
+		length = ret;
+	} else if (src != load_ptr) {
 		memcpy(load_ptr, src, length);
 	}
 
+#if CONFIG_IS_ENABLED(LOAD_FIT_STREAM)
+loaded:
+#endif
 	if (image_info) {
 		ulong entry_point;
 
@@ -8,6 +8,59 @@
 #include <scmi_agent.h>
 #include <scmi_protocols.h>
 #include <asm/types.h>
+#include <dm/devres.h>
+#include <linux/compat.h>
+
+/**
+ * struct scmi_clk_cache - Last known rate of an SCMI clock
+ * @rate:	Clock rate in Hertz, if @valid
+ * @valid:	True if @rate is the current rate of the clock
+ * @fixed:	True if the clock has a single rate, so @rate never goes stale
+ * @described:	True once the rates of the clock were asked for
+ */
+struct scmi_clk_cache {
+	ulong rate;
+	bool valid;
+	bool fixed;
+	bool described;
+};
+
+/**
+ * struct scmi_clk_priv - Private data for the SCMI clock device
+ * @num_clocks:	Number of clocks exposed by the SCMI server
+ * @cache:	Rates of clocks 0 to @num_clocks - 1, or NULL if not cached
+ */
+struct scmi_clk_priv {
+	uint num_clocks;
+	struct scmi_clk_cache *cache;
+};
+
+static struct scmi_clk_cache *scmi_clk_get_cache(struct clk *clk)
+{
+	struct scmi_clk_priv *priv = dev_get_priv(clk->dev);
+
+	if (!priv->cache || clk->id >= priv->num_clocks)
+		return NULL;
+
+	return &priv->cache[clk->id];
+}
+
+/*
+ * Setting the rate of a clock may change the rate of the clocks derived from
+ * it, so forget all rates but the fixed ones
+ */
+static void scmi_clk_invalidate(struct udevice *dev)
+{
+	struct scmi_clk_priv *priv = dev_get_priv(dev);
+	uint i;
+
+	if (!priv->cache)
+		return;
+
+	for (i = 0; i < priv->num_clocks; i++)
+		if (!priv->cache[i].fixed)
+			priv->cache[i].valid = false;
+}
 
 static int scmi_clk_gate(struct clk *clk, int enable)
 {
@@ -38,8 +91,48 @@ static int scmi_clk_disable(struct clk *clk)
 	return scmi_clk_gate(clk, 0);
 }
 
+/*
+ * Ask for the rates of a clock on its first read. If it has a single rate,
+ * that rate is kept and the clock is never read from the server.
+ */
+static void scmi_clk_describe(struct clk *clk, struct scmi_clk_cache *cache)
+{
+	struct scmi_clk_describe_rates_in in = {
+		.clock_id = clk->id,
+	};
+	struct scmi_clk_describe_rates_out out;
+	struct scmi_msg msg = SCMI_MSG_IN(SCMI_PROTOCOL_ID_CLOCK,
+					  SCMI_CLOCK_DESCRIBE_RATES,
+					  in, out);
+	uint num;
+
+	cache->described = true;
+	if (devm_scmi_process_msg(clk->dev->parent, &msg) || out.status)
+		return;
+
+	num = SCMI_CLK_RATES_NUM(out.num_rates_flags);
+	if (msg.out_msg_sz < sizeof(out) - sizeof(out.rate) +
+			     num * sizeof(out.rate[0]))
+		return;
+
+	/* A range gives its lowest rate, highest rate and step */
+	if (out.num_rates_flags & SCMI_CLK_RATES_RANGE) {
+		if (num != 3 || out.rate[0].rate_lsb != out.rate[1].rate_lsb ||
+		    out.rate[0].rate_msb != out.rate[1].rate_msb)
+			return;
+	} else if (num != 1 || SCMI_CLK_RATES_REMAINING(out.num_rates_flags)) {
+		return;
+	}
+
+	cache->rate = (ulong)(((u64)out.rate[0].rate_msb << 32) |
+			      out.rate[0].rate_lsb);
+	cache->valid = true;
+	cache->fixed = true;
+}
+
 static ulong scmi_clk_get_rate(struct clk *clk)
 {
+	struct scmi_clk_cache *cache = scmi_clk_get_cache(clk);
 	struct scmi_clk_rate_get_in in = {
 		.clock_id = clk->id,
 	};
@@ -47,8 +140,14 @@ static ulong scmi_clk_get_rate(struct clk *clk)
 	struct scmi_msg msg = SCMI_MSG_IN(SCMI_PROTOCOL_ID_CLOCK,
 					  SCMI_CLOCK_RATE_GET,
 					  in, out);
+	ulong rate;
 	int ret;
 
+	if (cache && !cache->described)
+		scmi_clk_describe(clk, cache);
+	if (cache && cache->valid)
+		return cache->rate;
+
 	ret = devm_scmi_process_msg(clk->dev->parent, &msg);
 	if (ret < 0)
 		return ret;
@@ -57,7 +156,13 @@ static ulong scmi_clk_get_rate(struct clk *clk)
 	if (ret < 0)
 		return ret;
 
-	return (ulong)(((u64)out.rate_msb << 32) | out.rate_lsb);
+	rate = (ulong)(((u64)out.rate_msb << 32) | out.rate_lsb);
+	if (cache) {
+		cache->rate = rate;
+		cache->valid = true;
+	}
+
+	return rate;
 }
 
 static ulong scmi_clk_set_rate(struct clk *clk, ulong rate)
@@ -75,6 +180,7 @@ static ulong scmi_clk_set_rate(struct clk *clk, ulong rate)
 	int ret;
 
 	ret = devm_scmi_process_msg(clk->dev->parent, &msg);
+	scmi_clk_invalidate(clk->dev);
 	if (ret < 0)
 		return ret;
 
@@ -85,6 +191,33 @@ static ulong scmi_clk_set_rate(struct clk *clk, ulong rate)
 	return scmi_clk_get_rate(clk);
 }
 
+static int scmi_clk_probe(struct udevice *dev)
+{
+	struct scmi_clk_priv *priv = dev_get_priv(dev);
+	struct scmi_clk_protocol_attr_in in = {};
+	struct scmi_clk_protocol_attr_out out;
+	struct scmi_msg msg = SCMI_MSG_IN(SCMI_PROTOCOL_ID_CLOCK,
+					  SCMI_CLOCK_PROTOCOL_ATTRIBUTES,
+					  in, out);
+
+	if (!IS_ENABLED(CONFIG_CLK_SCMI_RATE_CACHE))
+		return 0;
+
+	/* Without the number of clocks, every rate is read from the server */
+	if (devm_scmi_process_msg(dev->parent, &msg) || out.status)
+		return 0;
+
+	priv->num_clocks = SCMI_CLK_PROTO_ATTRS_NUM_CLOCKS(out.attributes);
+	if (!priv->num_clocks)
+		return 0;
+
+	/* Without memory for the cache, every rate is read as well */
+	priv->cache = devm_kcalloc(dev, priv->num_clocks, sizeof(*priv->cache),
+				   GFP_KERNEL);
+
+	return 0;
+}
+
 static const struct clk_ops scmi_clk_ops = {
 	.enable = scmi_clk_enable,
 	.disable = scmi_clk_disable,
@@ -96,4 +229,6 @@ U_BOOT_DRIVER(scmi_clock) = {
 	.name = "scmi_clk",
 	.id = UCLASS_CLK,
 	.ops = &scmi_clk_ops,
+	.probe = scmi_clk_probe,
+	.priv_auto = sizeof(struct scmi_clk_priv),
 };
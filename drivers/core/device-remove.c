@@ -110,6 +110,7 @@ int device_unbind(struct udevice *dev)
 	ret = uclass_unbind_device(dev);
 	if (ret)
 		return log_msg_ret("uc", ret);
+	device_index_remove(dev);
 
 	if (dev->parent)
 		list_del(&dev->sibling_node);
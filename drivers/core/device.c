@@ -161,6 +161,7 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 	ret = uclass_bind_device(dev);
 	if (ret)
 		goto fail_uclass_bind;
+	device_index_add(dev);
 
 	/* if we fail to bind we remove device from successors and free it */
 	if (drv->bind) {
@@ -200,6 +201,7 @@ fail_child_post_bind:
 
 fail_bind:
 	if (CONFIG_IS_ENABLED(DM_DEVICE_REMOVE)) {
+		device_index_remove(dev);
 		if (uclass_unbind_device(dev)) {
 			dm_warn("Failed to unbind dev '%s' on error path\n",
 				dev->name);
@@ -788,6 +790,122 @@ int device_get_child_by_of_offset(const struct udevice *parent, int node,
 	return device_get_device_tail(dev, ret, devp);
 }
 
+#if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+/* Multiplicative hash of a node reference or phandle to a bucket */
+static struct list_head *device_index_bucket(struct list_head *table,
+					     ulong key)
+{
+	return &table[((u32)key * 0x61c88647U) >> (32 - DM_OFNODE_INDEX_BITS)];
+}
+
+int device_index_init(void)
+{
+	struct dm_ofnode_index *index = gd_dm_ofnode_index();
+	int i;
+
+	if (!index) {
+		index = malloc(sizeof(*index));
+		if (!index)
+			return -ENOMEM;
+		gd_set_dm_ofnode_index(index);
+	}
+	for (i = 0; i < DM_OFNODE_INDEX_SIZE; i++) {
+		INIT_LIST_HEAD(&index->ofnode[i]);
+		INIT_LIST_HEAD(&index->phandle[i]);
+	}
+
+	return 0;
+}
+
+void device_index_add(struct udevice *dev)
+{
+	struct dm_ofnode_index *index = gd_dm_ofnode_index();
+	ofnode node = dev_ofnode(dev);
+	int phandle;
+
+	INIT_LIST_HEAD(&dev->ofnode_node);
+	INIT_LIST_HEAD(&dev->phandle_node);
+	if (!index || !ofnode_valid(node))
+		return;
+
+	list_add_tail(&dev->ofnode_node,
+		      device_index_bucket(index->ofnode, node.of_offset));
+	phandle = dev_read_phandle(dev);
+	if (phandle > 0)
+		list_add_tail(&dev->phandle_node,
+			      device_index_bucket(index->phandle, phandle));
+}
+
+void device_index_remove(struct udevice *dev)
+{
+	/* Devices that were never added have NULL list pointers */
+	if (dev->ofnode_node.next) {
+		list_del_init(&dev->ofnode_node);
+		list_del_init(&dev->phandle_node);
+	}
+}
+
+void device_index_set_ofnode(struct udevice *dev, ofnode node)
+{
+	/* Devices that are not bound yet are added when they are */
+	bool bound = dev->ofnode_node.next;
+
+	if (bound)
+		device_index_remove(dev);
+	dev->node_ = node;
+	if (bound)
+		device_index_add(dev);
+}
+
+int device_index_find_ofnode(ofnode node, enum uclass_id id,
+			     struct udevice **devp)
+{
+	struct dm_ofnode_index *index = gd_dm_ofnode_index();
+	struct list_head *bucket;
+	struct udevice *dev;
+	int count = 0;
+
+	*devp = NULL;
+	if (!index)
+		return -ENOSYS;
+
+	bucket = device_index_bucket(index->ofnode, node.of_offset);
+	list_for_each_entry(dev, bucket, ofnode_node) {
+		if (!ofnode_equal(dev_ofnode(dev), node))
+			continue;
+		if (id != UCLASS_INVALID && dev->uclass->uc_drv->id != id)
+			continue;
+		if (!count++)
+			*devp = dev;
+	}
+
+	return count;
+}
+
+int device_index_find_phandle(uint phandle, enum uclass_id id,
+			      struct udevice **devp)
+{
+	struct dm_ofnode_index *index = gd_dm_ofnode_index();
+	struct list_head *bucket;
+	struct udevice *dev;
+
+	*devp = NULL;
+	if (!index || !phandle)
+		return -ENOSYS;
+
+	bucket = device_index_bucket(index->phandle, phandle);
+	list_for_each_entry(dev, bucket, phandle_node) {
+		if (dev->uclass->uc_drv->id == id &&
+		    dev_read_phandle(dev) == phandle) {
+			*devp = dev;
+			return 0;
+		}
+	}
+
+	return -ENODEV;
+}
+#endif
+
 static struct udevice *_device_find_global_by_ofnode(struct udevice *parent,
 						     ofnode ofnode)
 {
@@ -805,9 +923,27 @@ static struct udevice *_device_find_global_by_ofnode(struct udevice *parent,
 	return NULL;
 }
 
+static struct udevice *device_find_global_ofnode(ofnode ofnode)
+{
+	struct udevice *dev;
+	int count;
+
+	/*
+	 * The index gives bind order, not tree order, so only use it when
+	 * there is at most one device to choose from
+	 */
+	if (ofnode_valid(ofnode)) {
+		count = device_index_find_ofnode(ofnode, UCLASS_INVALID, &dev);
+		if (count == 0 || count == 1)
+			return dev;
+	}
+
+	return _device_find_global_by_ofnode(gd->dm_root, ofnode);
+}
+
 int device_find_global_by_ofnode(ofnode ofnode, struct udevice **devp)
 {
-	*devp = _device_find_global_by_ofnode(gd->dm_root, ofnode);
+	*devp = device_find_global_ofnode(ofnode);
 
 	return *devp ? 0 : -ENOENT;
 }
@@ -816,7 +952,7 @@ int device_get_global_by_ofnode(ofnode ofnode, struct udevice **devp)
 {
 	struct udevice *dev;
 
-	dev = _device_find_global_by_ofnode(gd->dm_root, ofnode);
+	dev = device_find_global_ofnode(ofnode);
 	return device_get_device_tail(dev, dev ? 0 : -ENOENT, devp);
 }
 
@@ -9,8 +9,10 @@
 #define LOG_CATEGORY LOGC_DM
 
 #include <common.h>
+#include <bootstage.h>
 #include <errno.h>
 #include <log.h>
+#include <malloc.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -19,6 +21,10 @@
 #include <dm/util.h>
 #include <fdtdec.h>
 #include <linux/compiler.h>
+#include <linux/err.h>
+#include <asm/global_data.h>
+
+DECLARE_GLOBAL_DATA_PTR;
 
 struct driver *lists_driver_lookup_name(const char *name)
 {
@@ -181,6 +187,134 @@ static int driver_check_compatible(const struct udevice_id *of_match,
 	return -ENOENT;
 }
 
+/**
+ * struct dm_compat_index - Hash table of compatible strings
+ *
+ * Each slot holds the first driver in the linker list that matches a given
+ * compatible string, so a lookup finds the same driver as a walk of the
+ * list. Collisions are resolved by linear probing.
+ *
+ * @mask: Number of slots minus one, the number of slots is a power of two
+ * @slot: Slots, with @id NULL in empty slots
+ */
+struct dm_compat_index {
+	uint mask;
+	struct dm_compat_slot {
+		const struct udevice_id *id;
+		struct driver *drv;
+	} slot[];
+};
+
+/* FNV-1a, which spreads the long common prefixes of compatibles well */
+static uint dm_compat_hash(const char *compat)
+{
+	uint hash = 2166136261U;
+
+	while (*compat) {
+		hash ^= (u8)*compat++;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static struct dm_compat_slot *dm_compat_find(struct dm_compat_index *index,
+					     const char *compat)
+{
+	struct dm_compat_slot *slot;
+	uint i;
+
+	for (i = dm_compat_hash(compat);; i++) {
+		slot = &index->slot[i & index->mask];
+		if (!slot->id || !strcmp(slot->id->compatible, compat))
+			return slot;
+	}
+}
+
+/*
+ * Return the index for this phase, building it on first use, or NULL if
+ * there is not enough memory for it
+ */
+static struct dm_compat_index *dm_compat_index(void)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct udevice_id *id;
+	struct dm_compat_index *index;
+	struct dm_compat_slot *slot;
+	struct driver *entry;
+	uint count = 0;
+	uint size;
+
+	index = gd_dm_compat_index();
+	if (IS_ERR(index))
+		return NULL;
+	if (index)
+		return index;
+
+	bootstage_start(BOOTSTAGE_ID_ACCUM_DM_COMPAT, "dm_compat");
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (id = entry->of_match; id && id->compatible; id++)
+			count++;
+	}
+
+	/* Keep the table at most half full */
+	for (size = 16; size < count * 2; size *= 2)
+		;
+	index = calloc(1, sizeof(*index) + size * sizeof(index->slot[0]));
+	if (!index) {
+		/* Scan the driver list from now on rather than retry */
+		gd_set_dm_compat_index(ERR_PTR(-ENOMEM));
+		bootstage_accum(BOOTSTAGE_ID_ACCUM_DM_COMPAT);
+		return NULL;
+	}
+
+	index->mask = size - 1;
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (id = entry->of_match; id && id->compatible; id++) {
+			slot = dm_compat_find(index, id->compatible);
+			if (!slot->id) {
+				slot->id = id;
+				slot->drv = entry;
+			}
+		}
+	}
+	gd_set_dm_compat_index(index);
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_DM_COMPAT);
+
+	return index;
+}
+
+struct driver *lists_driver_lookup_compat(const char *compat,
+					  const struct udevice_id **idp)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	struct dm_compat_index *index = NULL;
+	struct dm_compat_slot *slot;
+	struct driver *entry;
+
+	/* The malloc() area before relocation is too small for the index */
+	if (CONFIG_IS_ENABLED(DM_COMPAT_INDEX) &&
+	    (IS_ENABLED(CONFIG_SPL_BUILD) || (gd->flags & GD_FLG_RELOC)))
+		index = dm_compat_index();
+	if (index) {
+		slot = dm_compat_find(index, compat);
+		if (!slot->id)
+			return NULL;
+		*idp = slot->id;
+
+		return slot->drv;
+	}
+
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		if (!driver_check_compatible(entry->of_match, idp, compat))
+			return entry;
+	}
+
+	return NULL;
+}
+
 int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 		   struct driver *drv, bool pre_reloc_only)
 {
@@ -222,16 +356,23 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 		log_debug("   - attempt to match compatible string '%s'\n",
 			  compat);
 
-		for (entry = driver; entry != driver + n_ents; entry++) {
-			ret = driver_check_compatible(entry->of_match, &id,
-						      compat);
-			if ((drv) && (drv == entry))
-				break;
-			if (!ret)
-				break;
+		if (drv) {
+			for (entry = driver; entry != driver + n_ents;
+			     entry++) {
+				ret = driver_check_compatible(entry->of_match,
+							      &id, compat);
+				if (drv == entry)
+					break;
+				if (!ret)
+					break;
+			}
+			if (entry == driver + n_ents)
+				continue;
+		} else {
+			entry = lists_driver_lookup_compat(compat, &id);
+			if (!entry)
+				continue;
 		}
-		if (entry == driver + n_ents)
-			continue;
 
 		if (pre_reloc_only) {
 			if (!ofnode_pre_reloc(node) &&
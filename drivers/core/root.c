@@ -174,6 +174,24 @@ int dm_init(bool of_live)
 		INIT_LIST_HEAD(DM_UCLASS_ROOT_NON_CONST);
 	}
 
+	/*
+	 * Without the table, uclass_find() falls back to the list. It is left
+	 * out before relocation, where the malloc() area is small
+	 */
+	if (CONFIG_IS_ENABLED(DM_UCLASS_TABLE) &&
+	    (IS_ENABLED(CONFIG_SPL_BUILD) || (gd->flags & GD_FLG_RELOC))) {
+		if (gd_uclass_table())
+			memset(gd_uclass_table(), '\0',
+			       UCLASS_COUNT * sizeof(struct uclass *));
+		else
+			gd_set_uclass_table(calloc(UCLASS_COUNT,
+						   sizeof(struct uclass *)));
+	}
+
+	/* The device index is left out before relocation as well */
+	if (IS_ENABLED(CONFIG_SPL_BUILD) || (gd->flags & GD_FLG_RELOC))
+		device_index_init();
+
 	if (IS_ENABLED(CONFIG_NEEDS_MANUAL_RELOC)) {
 		fix_drivers();
 		fix_uclass();
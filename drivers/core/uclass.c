@@ -23,20 +23,39 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+/* Return the table slot for @id, or NULL if there is none */
+static struct uclass **uclass_table_slot(enum uclass_id id)
+{
+	struct uclass **table = gd_uclass_table();
+
+	if (!table || id < 0 || id >= UCLASS_COUNT)
+		return NULL;
+
+	return &table[id];
+}
+
 struct uclass *uclass_find(enum uclass_id key)
 {
+	struct uclass **slot;
 	struct uclass *uc;
 
 	if (!gd->dm_root)
 		return NULL;
+
+	slot = uclass_table_slot(key);
+	if (slot && *slot)
+		return *slot;
+
 	/*
-	 * TODO(sjg@chromium.org): Optimise this, perhaps moving the found
-	 * node to the start of the list, or creating a linear array mapping
-	 * id to node.
+	 * Uclasses created at build time (of-platdata-inst) are only entered
+	 * into the table here, the first time they are looked up
 	 */
 	list_for_each_entry(uc, gd->uclass_root, sibling_node) {
-		if (uc->uc_drv->id == key)
+		if (uc->uc_drv->id == key) {
+			if (slot)
+				*slot = uc;
 			return uc;
+		}
 	}
 
 	return NULL;
@@ -54,6 +73,7 @@ struct uclass *uclass_find(enum uclass_id key)
 static int uclass_add(enum uclass_id id, struct uclass **ucp)
 {
 	struct uclass_driver *uc_drv;
+	struct uclass **slot;
 	struct uclass *uc;
 	int ret;
 
@@ -86,6 +106,9 @@ static int uclass_add(enum uclass_id id, struct uclass **ucp)
 	INIT_LIST_HEAD(&uc->sibling_node);
 	INIT_LIST_HEAD(&uc->dev_head);
 	list_add(&uc->sibling_node, DM_UCLASS_ROOT_NON_CONST);
+	slot = uclass_table_slot(id);
+	if (slot)
+		*slot = uc;
 
 	if (uc_drv->init) {
 		ret = uc_drv->init(uc);
@@ -101,6 +124,8 @@ fail:
 		free(uclass_get_priv(uc));
 		uclass_set_priv(uc, NULL);
 	}
+	if (slot)
+		*slot = NULL;
 	list_del(&uc->sibling_node);
 fail_mem:
 	free(uc);
@@ -111,6 +136,7 @@ fail_mem:
 int uclass_destroy(struct uclass *uc)
 {
 	struct uclass_driver *uc_drv;
+	struct uclass **slot;
 	struct udevice *dev;
 	int ret;
 
@@ -134,6 +160,9 @@ int uclass_destroy(struct uclass *uc)
 	uc_drv = uc->uc_drv;
 	if (uc_drv->destroy)
 		uc_drv->destroy(uc);
+	slot = uclass_table_slot(uc_drv->id);
+	if (slot)
+		*slot = NULL;
 	list_del(&uc->sibling_node);
 	if (uc_drv->priv_auto)
 		free(uclass_get_priv(uc));
@@ -381,6 +410,13 @@ int uclass_find_device_by_ofnode(enum uclass_id id, ofnode node,
 	if (ret)
 		return ret;
 
+	ret = device_index_find_ofnode(node, id, devp);
+	if (ret >= 0) {
+		ret = *devp ? 0 : -ENODEV;
+		goto done;
+	}
+	ret = 0;
+
 	uclass_foreach_dev(dev, uc) {
 		log(LOGC_DM, LOGL_DEBUG_CONTENT, "      - checking %s\n",
 		    dev->name);
@@ -414,6 +450,10 @@ int uclass_find_device_by_phandle(enum uclass_id id, struct udevice *parent,
 	if (ret)
 		return ret;
 
+	ret = device_index_find_phandle(find_phandle, id, devp);
+	if (ret != -ENOSYS)
+		return ret;
+
 	uclass_foreach_dev(dev, uc) {
 		uint phandle;
 
@@ -535,6 +575,10 @@ int uclass_get_device_by_phandle_id(enum uclass_id id, uint phandle_id,
 	if (ret)
 		return ret;
 
+	ret = device_index_find_phandle(phandle_id, id, &dev);
+	if (ret != -ENOSYS)
+		return uclass_get_device_tail(dev, ret, devp);
+
 	uclass_foreach_dev(dev, uc) {
 		uint phandle;
 
@@ -542,7 +586,7 @@ int uclass_get_device_by_phandle_id(enum uclass_id id, uint phandle_id,
 
 		if (phandle == phandle_id) {
 			*devp = dev;
-			return uclass_get_device_tail(dev, ret, devp);
+			return uclass_get_device_tail(dev, 0, devp);
 		}
 	}
 
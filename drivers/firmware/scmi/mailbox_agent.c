@@ -14,6 +14,7 @@
 #include <dm/device_compat.h>
 #include <dm/devres.h>
 #include <linux/compat.h>
+#include <linux/io.h>
 
 #include "smt.h"
 
@@ -24,21 +25,52 @@
  * @smt:	Shared memory buffer
  * @mbox:	Mailbox channel description
  * @timeout_us:	Timeout in microseconds for the mailbox transfer
+ * @num_slots:	Number of SMT channels the shared memory buffer is split into
+ * @slot_size:	Byte size of each of these channels
  */
 struct scmi_mbox_channel {
 	struct scmi_smt smt;
 	struct mbox_chan mbox;
 	ulong timeout_us;
+	uint num_slots;
+	size_t slot_size;
 };
 
-static int scmi_mbox_process_msg(struct udevice *dev, struct scmi_msg *msg)
+/* Get the SMT channel in slot @slot of the shared memory buffer */
+static struct scmi_smt scmi_mbox_slot(struct scmi_mbox_channel *chan,
+				      uint slot)
+{
+	return (struct scmi_smt){
+		.buf = chan->smt.buf + slot * chan->slot_size,
+		.size = chan->slot_size,
+	};
+}
+
+/*
+ * Load @count messages in the first @count slots, ring the doorbell once and
+ * collect the responses: the server handles every busy slot before it
+ * answers the doorbell.
+ */
+static int scmi_mbox_exchange(struct udevice *dev, struct scmi_msg *msgs,
+			      uint count)
 {
 	struct scmi_mbox_channel *chan = dev_get_priv(dev);
+	struct scmi_smt smt;
+	uint i;
 	int ret;
 
-	ret = scmi_write_msg_to_smt(dev, &chan->smt, msg);
-	if (ret)
-		return ret;
+	for (i = 0; i < count; i++) {
+		smt = scmi_mbox_slot(chan, i);
+		ret = scmi_write_msg_to_smt(dev, &smt, &msgs[i]);
+		if (ret) {
+			/* The server was not told, take the slots back */
+			while (i--) {
+				smt = scmi_mbox_slot(chan, i);
+				scmi_smt_put_channel(&smt);
+			}
+			return ret;
+		}
+	}
 
 	/* Give shm addr to mbox in case it is meaningful */
 	ret = mbox_send(&chan->mbox, chan->smt.buf);
@@ -47,21 +79,82 @@ static int scmi_mbox_process_msg(struct udevice *dev, struct scmi_msg *msg)
 		goto out;
 	}
 
-	/* Receive the response */
+	/* Receive the responses */
 	ret = mbox_recv(&chan->mbox, chan->smt.buf, chan->timeout_us);
 	if (ret) {
 		dev_err(dev, "Response failed: %d, abort\n", ret);
 		goto out;
 	}
 
-	ret = scmi_read_resp_from_smt(dev, &chan->smt, msg);
+	for (i = 0; i < count && !ret; i++) {
+		smt = scmi_mbox_slot(chan, i);
+		ret = scmi_read_resp_from_smt(dev, &smt, &msgs[i]);
+	}
 
 out:
-	scmi_clear_smt_channel(&chan->smt);
+	for (i = 0; i < count; i++) {
+		smt = scmi_mbox_slot(chan, i);
+		scmi_clear_smt_channel(&smt);
+	}
 
 	return ret;
 }
 
+static int scmi_mbox_process_msg(struct udevice *dev, struct scmi_msg *msg)
+{
+	return scmi_mbox_exchange(dev, msg, 1);
+}
+
+static int scmi_mbox_process_msgs(struct udevice *dev, struct scmi_msg *msgs,
+				  uint count)
+{
+	struct scmi_mbox_channel *chan = dev_get_priv(dev);
+	uint n;
+	int ret;
+
+	for (; count; msgs += n, count -= n) {
+		n = min(count, chan->num_slots);
+		ret = scmi_mbox_exchange(dev, msgs, n);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * Split the shared memory buffer into the number of SMT channels given by
+ * the "smt-slots" DT property, one by default
+ */
+static int scmi_mbox_get_slots(struct udevice *dev,
+			       struct scmi_mbox_channel *chan)
+{
+	struct scmi_smt smt;
+	uint i;
+
+	chan->num_slots = dev_read_u32_default(dev, "smt-slots", 1);
+	if (!chan->num_slots)
+		return -EINVAL;
+
+	chan->slot_size = chan->smt.size;
+	if (chan->num_slots == 1)
+		return 0;
+
+	chan->slot_size = ALIGN_DOWN(chan->smt.size / chan->num_slots,
+				     sizeof(u64));
+	if (chan->slot_size < sizeof(struct scmi_smt_header))
+		return -EINVAL;
+
+	/* The server only sets up the first channel */
+	for (i = 1; i < chan->num_slots; i++) {
+		smt = scmi_mbox_slot(chan, i);
+		memset_io(smt.buf, 0, sizeof(struct scmi_smt_header));
+		scmi_smt_put_channel(&smt);
+	}
+
+	return 0;
+}
+
 int scmi_mbox_probe(struct udevice *dev)
 {
 	struct scmi_mbox_channel *chan = dev_get_priv(dev);
@@ -76,8 +169,14 @@ int scmi_mbox_probe(struct udevice *dev)
 	}
 
 	ret = scmi_dt_get_smt_buffer(dev, &chan->smt);
-	if (ret)
+	if (ret) {
 		dev_err(dev, "Failed to get shm resources: %d\n", ret);
+		goto out;
+	}
+
+	ret = scmi_mbox_get_slots(dev, chan);
+	if (ret)
+		dev_err(dev, "Failed to split shm into slots: %d\n", ret);
 
 out:
 	if (ret)
@@ -93,6 +192,7 @@ static const struct udevice_id scmi_mbox_ids[] = {
 
 static const struct scmi_agent_ops scmi_mbox_ops = {
 	.process_msg = scmi_mbox_process_msg,
+	.process_msgs = scmi_mbox_process_msgs,
 };
 
 U_BOOT_DRIVER(scmi_mbox) = {
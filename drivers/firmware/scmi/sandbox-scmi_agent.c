@@ -30,6 +30,10 @@
  * See IDs in scmi1_clk[] and "sandbox-scmi-agent@1" in test.dts.
  *
  * All clocks and regulators are default disabled and reset controller down.
+ * Clock ID 7 of agent #0 has a fixed rate.
+ *
+ * Both agents take up to SANDBOX_SCMI_SLOTS messages per doorbell, as a
+ * mailbox transport with that many shared memory slots would.
  *
  * This Driver exports sandbox_scmi_service_ctx() for the test sequence to
  * get the state of the simulated services (clock state, rate, ...) and
@@ -38,9 +42,10 @@
  */
 
 #define SANDBOX_SCMI_AGENT_COUNT	2
+#define SANDBOX_SCMI_SLOTS		4
 
 static struct sandbox_scmi_clk scmi0_clk[] = {
-	{ .id = 7, .rate = 1000 },
+	{ .id = 7, .rate = 1000, .fixed = true },
 	{ .id = 3, .rate = 333 },
 };
 
@@ -156,6 +161,68 @@ static struct sandbox_scmi_voltd *get_scmi_voltd_state(uint agent_id,
  * Sandbox SCMI agent ops
  */
 
+static int sandbox_scmi_clock_protocol_attribs(struct udevice *dev,
+					       struct scmi_msg *msg)
+{
+	struct sandbox_scmi_agent *agent = dev_get_priv(dev);
+	struct scmi_clk_protocol_attr_out *out = NULL;
+	uint num_clocks = 0;
+	size_t n;
+
+	if (!msg->out_msg || msg->out_msg_sz < sizeof(*out))
+		return -EINVAL;
+
+	out = (struct scmi_clk_protocol_attr_out *)msg->out_msg;
+
+	/* Clock IDs are not contiguous, report the highest one plus 1 */
+	for (n = 0; n < agent->clk_count; n++)
+		num_clocks = max(num_clocks, agent->clk[n].id + 1);
+
+	out->attributes = num_clocks;
+	out->status = SCMI_SUCCESS;
+
+	return 0;
+}
+
+static int sandbox_scmi_clock_describe_rates(struct udevice *dev,
+					     struct scmi_msg *msg)
+{
+	struct sandbox_scmi_agent *agent = dev_get_priv(dev);
+	struct scmi_clk_describe_rates_in *in = NULL;
+	struct scmi_clk_describe_rates_out *out = NULL;
+	struct sandbox_scmi_clk *clk_state = NULL;
+
+	if (!msg->in_msg || msg->in_msg_sz < sizeof(*in) ||
+	    !msg->out_msg || msg->out_msg_sz < sizeof(*out))
+		return -EINVAL;
+
+	in = (struct scmi_clk_describe_rates_in *)msg->in_msg;
+	out = (struct scmi_clk_describe_rates_out *)msg->out_msg;
+
+	/* Unused IDs are expected here, so do not complain about them */
+	clk_state = get_scmi_clk_state(agent->idx, in->clock_id);
+	if (!clk_state) {
+		out->status = SCMI_NOT_FOUND;
+	} else if (in->rate_index) {
+		out->status = SCMI_OUT_OF_RANGE;
+	} else if (clk_state->fixed) {
+		/* A single discrete rate */
+		out->num_rates_flags = 1;
+		out->rate[0].rate_lsb = (u32)clk_state->rate;
+		out->rate[0].rate_msb = (u32)((u64)clk_state->rate >> 32);
+		out->status = SCMI_SUCCESS;
+	} else {
+		/* Any rate from 1Hz to 4GHz */
+		out->num_rates_flags = SCMI_CLK_RATES_RANGE | 3;
+		out->rate[0] = (struct scmi_clk_rate){ .rate_lsb = 1 };
+		out->rate[1] = (struct scmi_clk_rate){ .rate_msb = 1 };
+		out->rate[2] = (struct scmi_clk_rate){ .rate_lsb = 1 };
+		out->status = SCMI_SUCCESS;
+	}
+
+	return 0;
+}
+
 static int sandbox_scmi_clock_rate_set(struct udevice *dev,
 				       struct scmi_msg *msg)
 {
@@ -176,6 +243,8 @@ static int sandbox_scmi_clock_rate_set(struct udevice *dev,
 		dev_err(dev, "Unexpected clock ID %u\n", in->clock_id);
 
 		out->status = SCMI_NOT_FOUND;
+	} else if (clk_state->fixed) {
+		out->status = SCMI_DENIED;
 	} else {
 		u64 rate = ((u64)in->rate_msb << 32) + in->rate_lsb;
 
@@ -473,12 +542,19 @@ static int sandbox_scmi_voltd_level_get(struct udevice *dev,
 	return 0;
 }
 
-static int sandbox_scmi_test_process_msg(struct udevice *dev,
-					 struct scmi_msg *msg)
+static int sandbox_scmi_handle_msg(struct udevice *dev, struct scmi_msg *msg)
 {
+	struct sandbox_scmi_agent *agent = dev_get_priv(dev);
+
+	agent->msg_count++;
+
 	switch (msg->protocol_id) {
 	case SCMI_PROTOCOL_ID_CLOCK:
 		switch (msg->message_id) {
+		case SCMI_CLOCK_PROTOCOL_ATTRIBUTES:
+			return sandbox_scmi_clock_protocol_attribs(dev, msg);
+		case SCMI_CLOCK_DESCRIBE_RATES:
+			return sandbox_scmi_clock_describe_rates(dev, msg);
 		case SCMI_CLOCK_RATE_SET:
 			return sandbox_scmi_clock_rate_set(dev, msg);
 		case SCMI_CLOCK_RATE_GET:
@@ -537,6 +613,35 @@ static int sandbox_scmi_test_process_msg(struct udevice *dev,
 	return 0;
 }
 
+static int sandbox_scmi_test_process_msg(struct udevice *dev,
+					 struct scmi_msg *msg)
+{
+	struct sandbox_scmi_agent *agent = dev_get_priv(dev);
+
+	agent->doorbell_count++;
+
+	return sandbox_scmi_handle_msg(dev, msg);
+}
+
+static int sandbox_scmi_test_process_msgs(struct udevice *dev,
+					  struct scmi_msg *msgs, uint count)
+{
+	struct sandbox_scmi_agent *agent = dev_get_priv(dev);
+	uint i;
+	int ret;
+
+	for (i = 0; i < count; i++) {
+		if (!(i % SANDBOX_SCMI_SLOTS))
+			agent->doorbell_count++;
+
+		ret = sandbox_scmi_handle_msg(dev, &msgs[i]);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 static int sandbox_scmi_test_remove(struct udevice *dev)
 {
 	struct sandbox_scmi_agent *agent = dev_get_priv(dev);
@@ -598,6 +703,7 @@ static const struct udevice_id sandbox_scmi_test_ids[] = {
 
 struct scmi_agent_ops sandbox_scmi_test_ops = {
 	.process_msg = sandbox_scmi_test_process_msg,
+	.process_msgs = sandbox_scmi_test_process_msgs,
 };
 
 U_BOOT_DRIVER(sandbox_scmi_agent) = {
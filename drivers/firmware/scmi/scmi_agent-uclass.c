@@ -8,6 +8,7 @@
 #include <common.h>
 #include <dm.h>
 #include <errno.h>
+#include <scmi_agent.h>
 #include <scmi_agent-uclass.h>
 #include <scmi_protocols.h>
 #include <dm/device_compat.h>
@@ -124,6 +125,25 @@ int devm_scmi_process_msg(struct udevice *dev, struct scmi_msg *msg)
 	return -EPROTONOSUPPORT;
 }
 
+int devm_scmi_process_msgs(struct udevice *dev, struct scmi_msg *msgs,
+			   uint count)
+{
+	const struct scmi_agent_ops *ops = transport_dev_ops(dev);
+	uint i;
+	int ret;
+
+	if (ops->process_msgs)
+		return ops->process_msgs(dev, msgs, count);
+
+	for (i = 0; i < count; i++) {
+		ret = devm_scmi_process_msg(dev, &msgs[i]);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 UCLASS_DRIVER(scmi_agent) = {
 	.id		= UCLASS_SCMI_AGENT,
 	.name		= "scmi_agent",
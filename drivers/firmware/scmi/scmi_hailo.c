@@ -15,12 +15,12 @@ struct scmi_hailo_empty_out {};
 		struct _struct_name response; \
 	} __packed _out_variable_name
 
-int scmi_hailo_configure_ethernet_delay(
+int scmi_hailo_configure_ethernet(
 		struct udevice *dev, uint8_t tx_bypass_clock_delay, uint8_t tx_clock_inversion,
 		uint8_t tx_clock_delay, uint8_t rx_bypass_clock_delay,
-		uint8_t rx_clock_inversion, uint8_t rx_clock_delay) {
+		uint8_t rx_clock_inversion, uint8_t rx_clock_delay, bool rmii) {
 	int ret;
-	struct scmi_hailo_eth_delay_configuration_a2p in = {
+	struct scmi_hailo_eth_delay_configuration_a2p delay_in = {
 			.tx_bypass_clock_delay = rx_bypass_clock_delay,
 			.tx_clock_inversion = tx_clock_inversion,
 			.tx_clock_delay = tx_clock_delay,
@@ -28,21 +28,42 @@ int scmi_hailo_configure_ethernet_delay(
 			.rx_clock_inversion = rx_clock_inversion,
 			.rx_clock_delay = rx_clock_delay,
 	};
-	DECLARE_SCMI_HAILO_OUT(scmi_hailo_empty_out, out);
-
-	struct scmi_msg msg = SCMI_MSG_IN(SCMI_PROTOCOL_ID_HAILO,
-					  SCMI_HAILO_CONFIGURE_ETH_DELAY_ID, in, out);
+	struct scmi_hailo_empty_in rmii_in = {};
+	DECLARE_SCMI_HAILO_OUT(scmi_hailo_empty_out, delay_out);
+	DECLARE_SCMI_HAILO_OUT(scmi_hailo_empty_out, rmii_out);
+
+	/* Both settings are independent, send them with a single doorbell */
+	struct scmi_msg msgs[] = {
+		SCMI_MSG_IN(SCMI_PROTOCOL_ID_HAILO,
+			    SCMI_HAILO_CONFIGURE_ETH_DELAY_ID, delay_in, delay_out),
+		SCMI_MSG_IN(SCMI_PROTOCOL_ID_HAILO,
+			    SCMI_HAILO_SET_ETH_RMII_MODE_ID, rmii_in, rmii_out),
+	};
 
-	ret = devm_scmi_process_msg(dev, &msg);
+	ret = devm_scmi_process_msgs(dev, msgs, rmii ? 2 : 1);
 	if (ret)
 		return ret;
 
-	if (out.status)
-		return scmi_to_linux_errno(out.status);
+	if (delay_out.status)
+		return scmi_to_linux_errno(delay_out.status);
+
+	if (rmii && rmii_out.status)
+		return scmi_to_linux_errno(rmii_out.status);
 
 	return 0;
 }
 
+int scmi_hailo_configure_ethernet_delay(
+		struct udevice *dev, uint8_t tx_bypass_clock_delay, uint8_t tx_clock_inversion,
+		uint8_t tx_clock_delay, uint8_t rx_bypass_clock_delay,
+		uint8_t rx_clock_inversion, uint8_t rx_clock_delay) {
+	return scmi_hailo_configure_ethernet(dev, tx_bypass_clock_delay,
+					     tx_clock_inversion, tx_clock_delay,
+					     rx_bypass_clock_delay,
+					     rx_clock_inversion, rx_clock_delay,
+					     false);
+}
+
 int scmi_hailo_set_eth_rmii(struct udevice *dev) {
 	int ret;
 	struct scmi_hailo_empty_in in = {};
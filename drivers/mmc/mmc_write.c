@@ -127,12 +127,35 @@ ulong mmc_berase(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt)
 	return blk;
 }
 
+uint mmc_erase_zero_grp(struct mmc *mmc)
+{
+	/* SD cards report this in the SCR, which is not kept */
+	if (IS_SD(mmc) || !mmc->ext_csd ||
+	    mmc->ext_csd[EXT_CSD_ERASED_MEM_CONT])
+		return 0;
+
+	return mmc->erase_grp_size;
+}
+
+/*
+ * A pre-defined multiple block write (CMD23 before CMD25) tells the eMMC
+ * the transfer size up front, so it can plan programming of the whole
+ * chunk and no STOP_TRANSMISSION busy period follows the data.
+ */
+static bool mmc_use_set_block_count(struct mmc *mmc, lbaint_t blkcnt)
+{
+	return IS_ENABLED(CONFIG_MMC_WRITE_SET_BLOCK_COUNT) && blkcnt > 1 &&
+	       !mmc_host_is_spi(mmc) && IS_MMC(mmc) &&
+	       mmc->version >= MMC_VERSION_4_3;
+}
+
 static ulong mmc_write_blocks(struct mmc *mmc, lbaint_t start,
 		lbaint_t blkcnt, const void *src)
 {
 	struct mmc_cmd cmd;
 	struct mmc_data data;
 	int timeout_ms = 1000;
+	bool predefined = mmc_use_set_block_count(mmc, blkcnt);
 
 	if ((start + blkcnt) > mmc_get_blk_desc(mmc)->lba) {
 		printf("MMC: block number 0x" LBAF " exceeds max(0x" LBAF ")\n",
@@ -142,7 +165,18 @@ static ulong mmc_write_blocks(struct mmc *mmc, lbaint_t start,
 
 	if (blkcnt == 0)
 		return 0;
-	else if (blkcnt == 1)
+
+	if (predefined) {
+		cmd.cmdidx = MMC_CMD_SET_BLOCK_COUNT;
+		cmd.cmdarg = blkcnt & 0xFFFF;
+		cmd.resp_type = MMC_RSP_R1;
+		if (mmc_send_cmd(mmc, &cmd, NULL)) {
+			printf("mmc fail to set block count\n");
+			return 0;
+		}
+	}
+
+	if (blkcnt == 1)
 		cmd.cmdidx = MMC_CMD_WRITE_SINGLE_BLOCK;
 	else
 		cmd.cmdidx = MMC_CMD_WRITE_MULTIPLE_BLOCK;
@@ -167,7 +201,7 @@ static ulong mmc_write_blocks(struct mmc *mmc, lbaint_t start,
 	/* SPI multiblock writes terminate using a special
 	 * token, not a STOP_TRANSMISSION request.
 	 */
-	if (!mmc_host_is_spi(mmc) && blkcnt > 1) {
+	if (!mmc_host_is_spi(mmc) && blkcnt > 1 && !predefined) {
 		cmd.cmdidx = MMC_CMD_STOP_TRANSMISSION;
 		cmd.cmdarg = 0;
 		cmd.resp_type = MMC_RSP_R1b;
@@ -213,6 +247,9 @@ ulong mmc_bwrite(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
 	do {
 		cur = (blocks_todo > mmc->cfg->b_max) ?
 			mmc->cfg->b_max : blocks_todo;
+		/* CMD23 carries a 16-bit block count */
+		if (mmc_use_set_block_count(mmc, cur) && cur > 0xFFFF)
+			cur = 0xFFFF;
 		if (mmc_write_blocks(mmc, start, cur, src) != cur)
 			return 0;
 		blocks_todo -= cur;
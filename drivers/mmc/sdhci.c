@@ -19,8 +19,10 @@
 #include <linux/bitops.h>
 #include <linux/delay.h>
 #include <linux/dma-mapping.h>
+#include <linux/math64.h>
 #include <phys2bus.h>
 #include <power/regulator.h>
+#include <time.h>
 
 static void sdhci_reset(struct sdhci_host *host, u8 mask)
 {
@@ -130,15 +132,49 @@ static void sdhci_prepare_dma(struct sdhci_host *host, struct mmc_data *data,
 			      int *is_aligned, int trans_bytes)
 {}
 #endif
+/* Give up on a data transfer after 10 s */
+#define SDHCI_DATA_TIMEOUT_US			10000000
+#define SDHCI_DATA_POLL_US			10
+
+#if IS_ENABLED(CONFIG_MMC_SDHCI_ADAPTIVE_POLL)
+#define SDHCI_DMA_POLL_BACKOFF_US	CONFIG_MMC_SDHCI_POLL_BACKOFF_US
+#else
+#define SDHCI_DMA_POLL_BACKOFF_US	SDHCI_DATA_POLL_US
+#endif
+
+/*
+ * Time the bus needs to move @data, ignoring card busy periods. DMA
+ * completion is polled without delay until this much time has passed.
+ */
+static ulong sdhci_data_time_us(struct sdhci_host *host, struct mmc_data *data)
+{
+	struct mmc *mmc = host->mmc;
+	u64 bits = (u64)data->blocks * data->blocksize * 8;
+	u64 rate = (u64)mmc->clock * mmc->bus_width;
+
+	if (!IS_ENABLED(CONFIG_MMC_SDHCI_ADAPTIVE_POLL) ||
+	    !(host->flags & USE_DMA))
+		return 0;
+
+	if (mmc->ddr_mode)
+		rate *= 2;
+	if (!rate)
+		return 0;
+
+	return div64_u64(bits * 1000000, rate);
+}
+
 static int sdhci_transfer_data(struct sdhci_host *host, struct mmc_data *data)
 {
 	dma_addr_t start_addr = host->start_addr;
-	unsigned int stat, rdy, mask, timeout, block = 0;
+	unsigned int stat, rdy, mask, block = 0;
 	bool transfer_done = false;
+	ulong start, elapsed, expected;
 
-	timeout = 1000000;
+	expected = sdhci_data_time_us(host, data);
 	rdy = SDHCI_INT_SPACE_AVAIL | SDHCI_INT_DATA_AVAIL;
 	mask = SDHCI_DATA_AVAILABLE | SDHCI_SPACE_AVAILABLE;
+	start = timer_get_us();
 	do {
 		stat = sdhci_readl(host, SDHCI_INT_STATUS);
 		if (stat & SDHCI_INT_ERROR) {
@@ -173,13 +209,19 @@ static int sdhci_transfer_data(struct sdhci_host *host, struct mmc_data *data)
 				sdhci_writel(host, start_addr, SDHCI_DMA_ADDRESS);
 			}
 		}
-		if (timeout-- > 0)
-			udelay(10);
-		else {
+		if (stat & SDHCI_INT_DATA_END)
+			break;
+
+		elapsed = timer_get_us() - start;
+		if (elapsed > SDHCI_DATA_TIMEOUT_US) {
 			printf("%s: Transfer data timeout\n", __func__);
 			return -ETIMEDOUT;
 		}
-	} while (!(stat & SDHCI_INT_DATA_END));
+		if (!expected)
+			udelay(SDHCI_DATA_POLL_US);
+		else if (elapsed > expected)
+			udelay(SDHCI_DMA_POLL_BACKOFF_US);
+	} while (1);
 
 #if (defined(CONFIG_MMC_SDHCI_SDMA) || CONFIG_IS_ENABLED(MMC_SDHCI_ADMA))
 	dma_unmap_single(host->start_addr, data->blocks * data->blocksize,
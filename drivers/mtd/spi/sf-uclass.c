@@ -9,27 +9,167 @@
 #include <dm.h>
 #include <log.h>
 #include <malloc.h>
+#include <memalign.h>
 #include <spi.h>
 #include <spi_flash.h>
 #include <asm/global_data.h>
 #include <dm/device-internal.h>
+#include <linux/sizes.h>
 #include "sf_internal.h"
 
 DECLARE_GLOBAL_DATA_PTR;
 
+#if CONFIG_IS_ENABLED(SPI_FLASH_READ_CACHE)
+#define SF_CACHE_SECT_SIZE	SZ_4K
+#define SF_CACHE_SECTORS	CONFIG_VAL(SPI_FLASH_READ_CACHE_SECTORS)
+#define SF_CACHE_SIZE		(SF_CACHE_SECTORS * SF_CACHE_SECT_SIZE)
+
+/* A flash sector held by the read cache */
+struct sf_cache_sector {
+	struct udevice *dev;	/* flash device, NULL if the slot is unused */
+	u32 offset;		/* offset of the sector in the flash */
+	ulong used;		/* LRU stamp of the last access */
+};
+
+/*
+ * Sectors of recent small reads, shared by all flash devices so that the
+ * memory used is bounded. Slot i holds its data at buf + i * sector size.
+ */
+static struct {
+	u8 *buf;		/* allocated on the first cached read */
+	ulong stamp;		/* LRU clock */
+	ulong hits;
+	ulong misses;
+	struct sf_cache_sector sect[SF_CACHE_SECTORS];
+} sf_cache;
+
+/*
+ * Drop the cached sectors of @dev that overlap [@offset, @offset + @len).
+ * Besides the uclass write and erase below, the SPI NOR core calls this, so
+ * that writes through the MTD device (mtd, UBI) are seen too.
+ */
+void spi_flash_cache_invalidate(struct udevice *dev, u32 offset, size_t len)
+{
+	struct sf_cache_sector *sect;
+	int i;
+
+	for (i = 0; i < SF_CACHE_SECTORS; i++) {
+		sect = &sf_cache.sect[i];
+		if (sect->dev == dev &&
+		    sect->offset < offset + len &&
+		    offset < sect->offset + SF_CACHE_SECT_SIZE)
+			sect->dev = NULL;
+	}
+}
+
+/* Return the data of the sector at @offset, reading it on a miss */
+static u8 *sf_cache_get(struct udevice *dev, u32 offset, int *retp)
+{
+	struct spi_flash *flash = dev_get_uclass_priv(dev);
+	struct sf_cache_sector *sect, *lru = NULL;
+	size_t len = SF_CACHE_SECT_SIZE;
+	u8 *data;
+	int i;
+
+	for (i = 0; i < SF_CACHE_SECTORS; i++) {
+		sect = &sf_cache.sect[i];
+		if (sect->dev == dev && sect->offset == offset) {
+			sf_cache.hits++;
+			sect->used = ++sf_cache.stamp;
+			return sf_cache.buf + i * SF_CACHE_SECT_SIZE;
+		}
+		if (!lru || !sect->dev ||
+		    (lru->dev && sect->used < lru->used))
+			lru = sect;
+	}
+
+	sf_cache.misses++;
+	i = lru - sf_cache.sect;
+	data = sf_cache.buf + i * SF_CACHE_SECT_SIZE;
+	if (flash->size && offset + len > flash->size)
+		len = flash->size - offset;
+
+	lru->dev = NULL;
+	*retp = sf_get_ops(dev)->read(dev, offset, len, data);
+	if (*retp)
+		return NULL;
+	lru->dev = dev;
+	lru->offset = offset;
+	lru->used = ++sf_cache.stamp;
+
+	return data;
+}
+
+static int sf_cache_read(struct udevice *dev, u32 offset, size_t len,
+			 void *buf)
+{
+	struct spi_flash *flash = dev_get_uclass_priv(dev);
+	size_t skip, chunk;
+	u32 sect_offset;
+	u8 *data;
+	int ret;
+
+	/* Large reads would only evict everything, and need no help */
+	if (len >= SF_CACHE_SIZE ||
+	    (flash->size && (offset >= flash->size ||
+			     len > flash->size - offset)))
+		return sf_get_ops(dev)->read(dev, offset, len, buf);
+
+	if (!sf_cache.buf) {
+		sf_cache.buf = malloc_cache_aligned(SF_CACHE_SIZE);
+		if (!sf_cache.buf)
+			return sf_get_ops(dev)->read(dev, offset, len, buf);
+	}
+
+	while (len) {
+		sect_offset = ALIGN_DOWN(offset, SF_CACHE_SECT_SIZE);
+		skip = offset - sect_offset;
+		chunk = min(len, (size_t)SF_CACHE_SECT_SIZE - skip);
+
+		data = sf_cache_get(dev, sect_offset, &ret);
+		if (!data)
+			return ret;
+		memcpy(buf, data + skip, chunk);
+
+		offset += chunk;
+		buf += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+void spi_flash_cache_get_stats(ulong *hits, ulong *misses)
+{
+	*hits = sf_cache.hits;
+	*misses = sf_cache.misses;
+}
+#else
+static int sf_cache_read(struct udevice *dev, u32 offset, size_t len,
+			 void *buf)
+{
+	return sf_get_ops(dev)->read(dev, offset, len, buf);
+}
+
+#endif /* SPI_FLASH_READ_CACHE */
+
 int spi_flash_read_dm(struct udevice *dev, u32 offset, size_t len, void *buf)
 {
-	return log_ret(sf_get_ops(dev)->read(dev, offset, len, buf));
+	return log_ret(sf_cache_read(dev, offset, len, buf));
 }
 
 int spi_flash_write_dm(struct udevice *dev, u32 offset, size_t len,
 		       const void *buf)
 {
+	spi_flash_cache_invalidate(dev, offset, len);
+
 	return log_ret(sf_get_ops(dev)->write(dev, offset, len, buf));
 }
 
 int spi_flash_erase_dm(struct udevice *dev, u32 offset, size_t len)
 {
+	spi_flash_cache_invalidate(dev, offset, len);
+
 	return log_ret(sf_get_ops(dev)->erase(dev, offset, len));
 }
 
@@ -103,9 +243,17 @@ static int spi_flash_post_bind(struct udevice *dev)
 	return 0;
 }
 
+static int spi_flash_pre_remove(struct udevice *dev)
+{
+	spi_flash_cache_invalidate(dev, 0, U32_MAX);
+
+	return 0;
+}
+
 UCLASS_DRIVER(spi_flash) = {
 	.id		= UCLASS_SPI_FLASH,
 	.name		= "spi_flash",
 	.post_bind	= spi_flash_post_bind,
+	.pre_remove	= spi_flash_pre_remove,
 	.per_device_auto	= sizeof(struct spi_nor),
 };
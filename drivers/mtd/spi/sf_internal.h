@@ -13,6 +13,8 @@
 #include <linux/types.h>
 #include <linux/compiler.h>
 
+struct udevice;
+
 #define SPI_NOR_MAX_ID_LEN	6
 #define SPI_NOR_MAX_ADDR_WIDTH	4
 
@@ -94,4 +96,14 @@ static inline void spi_flash_mtd_unregister(struct spi_flash *flash)
 }
 #endif
 
+#if CONFIG_IS_ENABLED(SPI_FLASH_READ_CACHE)
+/* Drop the sectors of [@offset, @offset + @len) held by the read cache */
+void spi_flash_cache_invalidate(struct udevice *dev, u32 offset, size_t len);
+#else
+static inline void spi_flash_cache_invalidate(struct udevice *dev,
+					      u32 offset, size_t len)
+{
+}
+#endif
+
 #endif /* _SF_INTERNAL_H_ */
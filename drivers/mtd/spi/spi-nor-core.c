@@ -923,6 +923,7 @@ static int spi_nor_erase(struct mtd_info *mtd, struct erase_info *instr)
 
 	addr = instr->addr;
 	len = instr->len;
+	spi_flash_cache_invalidate(nor->dev, addr, len);
 
 	instr->state = MTD_ERASING;
 	addr_known = true;
@@ -1680,6 +1681,8 @@ static int spi_nor_write(struct mtd_info *mtd, loff_t to, size_t len,
 	size_t page_offset, page_remain, i;
 	ssize_t ret;
 
+	spi_flash_cache_invalidate(nor->dev, to, len);
+
 #ifdef CONFIG_SPI_FLASH_SST
 	/* sst nor chips use AAI word program */
 	if (nor->info->flags & SST_WRITE)
@@ -4,6 +4,7 @@
  */
 #include <common.h>
 #include <clk.h>
+#include <command.h>
 #include <cpu_func.h>
 #include <dm.h>
 #include <log.h>
@@ -60,8 +61,8 @@ DECLARE_GLOBAL_DATA_PTR;
 #define GEM_RX_BUFFER_SIZE		2048
 #define RX_BUFFER_MULTIPLE		64
 
-#define MACB_RX_RING_SIZE		32
-#define MACB_TX_RING_SIZE		16
+#define MACB_RX_RING_SIZE		CONFIG_MACB_RX_RING_SIZE
+#define MACB_TX_RING_SIZE		CONFIG_MACB_TX_RING_SIZE
 
 #define MACB_TX_TIMEOUT		1000
 #define MACB_AUTONEG_TIMEOUT	5000000
@@ -97,16 +98,23 @@ struct macb_dma_desc_64 {
 
 #define DMA_DESC_SIZE		16
 #define DMA_DESC_BYTES(n)	((n) * DMA_DESC_SIZE)
-#define MACB_TX_DMA_DESC_SIZE	(DMA_DESC_BYTES(MACB_TX_RING_SIZE))
-#define MACB_RX_DMA_DESC_SIZE	(DMA_DESC_BYTES(MACB_RX_RING_SIZE))
+#define MACB_TX_DMA_DESC_SIZE(m)	(DMA_DESC_BYTES((m)->tx_ring_size))
+#define MACB_RX_DMA_DESC_SIZE(m)	(DMA_DESC_BYTES((m)->rx_ring_size))
 #define MACB_TX_DUMMY_DMA_DESC_SIZE	(DMA_DESC_BYTES(1))
 
 #define DESC_PER_CACHELINE_32	(ARCH_DMA_MINALIGN/sizeof(struct macb_dma_desc))
 #define DESC_PER_CACHELINE_64	(ARCH_DMA_MINALIGN/DMA_DESC_SIZE)
 
 #define RXBUF_FRMLEN_MASK	0x00000fff
+#define RXBUF_JFRMLEN_MASK	0x00003fff
 #define TXBUF_FRMLEN_MASK	0x000007ff
 
+struct macb_stats {
+	unsigned long		rx_overruns;
+	unsigned long		rx_resource_errors;
+	unsigned long		tx_ring_full;
+};
+
 struct macb_device {
 	void			*regs;
 
@@ -114,6 +122,8 @@ struct macb_device {
 
 	const struct macb_config *config;
 
+	unsigned int		rx_ring_size;
+	unsigned int		tx_ring_size;
 	unsigned int		rx_tail;
 	unsigned int		tx_head;
 	unsigned int		tx_tail;
@@ -121,18 +131,23 @@ struct macb_device {
 	bool			wrapped;
 
 	void			*rx_buffer;
+	void			*rx_wrap_buffer;
 	void			*tx_buffer;
 	struct macb_dma_desc	*rx_ring;
 	struct macb_dma_desc	*tx_ring;
 	size_t			rx_buffer_size;
+	u32			rx_frmlen_mask;
 
 	unsigned long		rx_buffer_dma;
+	unsigned long		tx_buffer_dma;
 	unsigned long		rx_ring_dma;
 	unsigned long		tx_ring_dma;
 
 	struct macb_dma_desc	*dummy_desc;
 	unsigned long		dummy_desc_dma;
 
+	struct macb_stats	stats;
+
 	const struct device	*dev;
 #ifndef CONFIG_DM_ETH
 	struct eth_device	netdev;
@@ -309,11 +324,11 @@ static inline void macb_invalidate_ring_desc(struct macb_device *macb, bool rx)
 {
 	if (rx)
 		invalidate_dcache_range(macb->rx_ring_dma,
-			ALIGN(macb->rx_ring_dma + MACB_RX_DMA_DESC_SIZE,
+			ALIGN(macb->rx_ring_dma + MACB_RX_DMA_DESC_SIZE(macb),
 			      PKTALIGN));
 	else
 		invalidate_dcache_range(macb->tx_ring_dma,
-			ALIGN(macb->tx_ring_dma + MACB_TX_DMA_DESC_SIZE,
+			ALIGN(macb->tx_ring_dma + MACB_TX_DMA_DESC_SIZE(macb),
 			      PKTALIGN));
 }
 
@@ -321,23 +336,23 @@ static inline void macb_flush_ring_desc(struct macb_device *macb, bool rx)
 {
 	if (rx)
 		flush_dcache_range(macb->rx_ring_dma, macb->rx_ring_dma +
-				   ALIGN(MACB_RX_DMA_DESC_SIZE, PKTALIGN));
+				   ALIGN(MACB_RX_DMA_DESC_SIZE(macb), PKTALIGN));
 	else
 		flush_dcache_range(macb->tx_ring_dma, macb->tx_ring_dma +
-				   ALIGN(MACB_TX_DMA_DESC_SIZE, PKTALIGN));
+				   ALIGN(MACB_TX_DMA_DESC_SIZE(macb), PKTALIGN));
 }
 
 static inline void macb_flush_rx_buffer(struct macb_device *macb)
 {
 	flush_dcache_range(macb->rx_buffer_dma, macb->rx_buffer_dma +
-			   ALIGN(macb->rx_buffer_size * MACB_RX_RING_SIZE,
+			   ALIGN(macb->rx_buffer_size * macb->rx_ring_size,
 				 PKTALIGN));
 }
 
 static inline void macb_invalidate_rx_buffer(struct macb_device *macb)
 {
 	invalidate_dcache_range(macb->rx_buffer_dma, macb->rx_buffer_dma +
-				ALIGN(macb->rx_buffer_size * MACB_RX_RING_SIZE,
+				ALIGN(macb->rx_buffer_size * macb->rx_ring_size,
 				      PKTALIGN));
 }
 
@@ -361,6 +376,139 @@ static void macb_set_addr(struct macb_device *macb, struct macb_dma_desc *desc,
 	desc->addr = lower_32_bits(addr);
 }
 
+#ifdef CONFIG_MACB_ASYNC_TX
+static unsigned int macb_tx_desc(struct macb_device *macb, unsigned int idx)
+{
+	if (macb->config->hw_dma_cap & HW_DMA_CAP_64B)
+		return idx * 2;
+
+	return idx;
+}
+
+/*
+ * Flush only the cacheline holding one TX descriptor. Flushing the whole
+ * ring would also write back stale copies of descriptors the controller
+ * is still completing.
+ */
+static void macb_flush_tx_desc(struct macb_device *macb, unsigned int idx)
+{
+	unsigned long start = macb->tx_ring_dma +
+		macb_tx_desc(macb, idx) * sizeof(struct macb_dma_desc);
+
+	flush_dcache_range(rounddown(start, ARCH_DMA_MINALIGN),
+			   roundup(start + DMA_DESC_SIZE, ARCH_DMA_MINALIGN));
+}
+
+/*
+ * Give back the descriptors the controller is done with. An idle
+ * transmitter leaves its queue pointer on the descriptor whose used bit
+ * stopped it, so every descriptor before that one has been sent, even if
+ * its TX_USED write-back was lost to a cacheline flush of a neighbouring
+ * descriptor. If that descriptor has since been queued (TX_USED clear),
+ * the TSTART written for it came while TGO was still set and was ignored,
+ * so transmission is started again rather than the frame reclaimed.
+ */
+static void macb_tx_reclaim(struct macb_device *macb, const char *name)
+{
+	unsigned int desc_size = macb_tx_desc(macb, 1) *
+				 sizeof(struct macb_dma_desc);
+	unsigned int tail = macb->tx_tail;
+	unsigned int stop = macb->tx_head;
+	bool idle;
+	u32 ctrl;
+
+	idle = !(macb_readl(macb, TSR) & MACB_BIT(TGO));
+	if (idle)
+		stop = (macb_readl(macb, TBQP) -
+			lower_32_bits(macb->tx_ring_dma)) / desc_size;
+	barrier();
+	macb_invalidate_ring_desc(macb, TX);
+
+	while (tail != macb->tx_head) {
+		ctrl = macb->tx_ring[macb_tx_desc(macb, tail)].ctrl;
+		if (idle ? tail == stop : !(ctrl & MACB_BIT(TX_USED)))
+			break;
+
+		if (ctrl & MACB_BIT(TX_UNDERRUN))
+			printf("%s: TX underrun\n", name);
+		if (ctrl & MACB_BIT(TX_BUF_EXHAUSTED))
+			printf("%s: TX buffers exhausted in mid frame\n", name);
+
+		if (++tail >= macb->tx_ring_size)
+			tail = 0;
+	}
+
+	macb->tx_tail = tail;
+
+	if (idle && tail != macb->tx_head)
+		macb_writel(macb, NCR, MACB_BIT(TE) | MACB_BIT(RE) |
+			    MACB_BIT(TSTART));
+}
+
+static int _macb_send(struct macb_device *macb, const char *name, void *packet,
+		      int length)
+{
+	unsigned int tx_head = macb->tx_head;
+	unsigned int next_head;
+	unsigned long paddr, ctrl;
+	int i;
+
+	if (length > PKTSIZE_ALIGN)
+		return -EINVAL;
+
+	next_head = tx_head + 1;
+	if (next_head >= macb->tx_ring_size)
+		next_head = 0;
+
+	/* Only wait for the controller when every descriptor is in flight */
+	for (i = 0; i <= MACB_TX_TIMEOUT; i++) {
+		macb_tx_reclaim(macb, name);
+		if (next_head != macb->tx_tail)
+			break;
+		if (!i)
+			macb->stats.tx_ring_full++;
+		udelay(1);
+	}
+
+	if (i > MACB_TX_TIMEOUT) {
+		printf("%s: TX timeout\n", name);
+		return -ETIMEDOUT;
+	}
+
+	/*
+	 * The networking core may re-use the packet as soon as we return,
+	 * so the frame is sent from the buffer owned by this descriptor.
+	 */
+	paddr = macb->tx_buffer_dma + tx_head * PKTSIZE_ALIGN;
+	memcpy(macb->tx_buffer + tx_head * PKTSIZE_ALIGN, packet, length);
+	flush_dcache_range(paddr, paddr + ALIGN(length, ARCH_DMA_MINALIGN));
+
+	/* Make sure the controller stops after this frame */
+	ctrl = MACB_BIT(TX_USED);
+	if (next_head == (macb->tx_ring_size - 1))
+		ctrl |= MACB_BIT(TX_WRAP);
+	macb->tx_ring[macb_tx_desc(macb, next_head)].ctrl = ctrl;
+
+	ctrl = length & TXBUF_FRMLEN_MASK;
+	ctrl |= MACB_BIT(TX_LAST);
+	if (tx_head == (macb->tx_ring_size - 1))
+		ctrl |= MACB_BIT(TX_WRAP);
+
+	macb_set_addr(macb, &macb->tx_ring[macb_tx_desc(macb, tx_head)], paddr);
+	barrier();
+	macb->tx_ring[macb_tx_desc(macb, tx_head)].ctrl = ctrl;
+
+	barrier();
+	macb_flush_tx_desc(macb, next_head);
+	macb_flush_tx_desc(macb, tx_head);
+	macb->tx_head = next_head;
+
+	/* Ignored if TGO is still set, macb_tx_reclaim() then restarts it */
+	macb_writel(macb, NCR, MACB_BIT(TE) | MACB_BIT(RE) | MACB_BIT(TSTART));
+
+	return 0;
+}
+#else
 static int _macb_send(struct macb_device *macb, const char *name, void *packet,
 		      int length)
 {
@@ -372,7 +520,7 @@ static int _macb_send(struct macb_device *macb, const char *name, void *packet,
 
 	ctrl = length & TXBUF_FRMLEN_MASK;
 	ctrl |= MACB_BIT(TX_LAST);
-	if (tx_head == (MACB_TX_RING_SIZE - 1)) {
+	if (tx_head == (macb->tx_ring_size - 1)) {
 		ctrl |= MACB_BIT(TX_WRAP);
 		macb->tx_head = 0;
 	} else {
@@ -416,6 +564,7 @@ static int _macb_send(struct macb_device *macb, const char *name, void *packet,
 	/* No one cares anyway */
 	return 0;
 }
+#endif
 
 static void reclaim_rx_buffer(struct macb_device *macb,
 			      unsigned int idx)
@@ -461,7 +610,7 @@ static void reclaim_rx_buffers(struct macb_device *macb,
 	while (i > new_tail) {
 		reclaim_rx_buffer(macb, i);
 		i++;
-		if (i >= MACB_RX_RING_SIZE)
+		if (i >= macb->rx_ring_size)
 			i = 0;
 	}
 
@@ -508,20 +657,19 @@ static int _macb_recv(struct macb_device *macb, uchar **packetp)
 		if (status & MACB_BIT(RX_EOF)) {
 			buffer = macb->rx_buffer +
 				macb->rx_buffer_size * macb->rx_tail;
-			length = status & RXBUF_FRMLEN_MASK;
+			length = status & macb->rx_frmlen_mask;
 
 			macb_invalidate_rx_buffer(macb);
 			if (macb->wrapped) {
+				void *packet = macb->rx_wrap_buffer;
 				unsigned int headlen, taillen;
 
 				headlen = macb->rx_buffer_size *
-					(MACB_RX_RING_SIZE - macb->rx_tail);
+					(macb->rx_ring_size - macb->rx_tail);
 				taillen = length - headlen;
-				memcpy((void *)net_rx_packets[0],
-				       buffer, headlen);
-				memcpy((void *)net_rx_packets[0] + headlen,
-				       macb->rx_buffer, taillen);
-				*packetp = (void *)net_rx_packets[0];
+				memcpy(packet, buffer, headlen);
+				memcpy(packet + headlen, macb->rx_buffer, taillen);
+				*packetp = packet;
 			} else {
 				*packetp = buffer;
 			}
@@ -531,7 +679,7 @@ static int _macb_recv(struct macb_device *macb, uchar **packetp)
 					next_rx_tail = next_rx_tail / 2;
 			}
 
-			if (++next_rx_tail >= MACB_RX_RING_SIZE)
+			if (++next_rx_tail >= macb->rx_ring_size)
 				next_rx_tail = 0;
 			macb->next_rx_tail = next_rx_tail;
 			return length;
@@ -542,7 +690,7 @@ static int _macb_recv(struct macb_device *macb, uchar **packetp)
 				flag = false;
 			}
 
-			if (++next_rx_tail >= MACB_RX_RING_SIZE) {
+			if (++next_rx_tail >= macb->rx_ring_size) {
 				macb->wrapped = true;
 				next_rx_tail = 0;
 			}
@@ -671,26 +819,19 @@ static int macb_hailo15_clk_init(struct udevice *dev, ulong rate)
 		return ret;
 	}
 
-	ret = scmi_hailo_configure_ethernet_delay(scmi_agent_dev,
+	/* The delays and the RMII mode are set with a single SCMI exchange */
+	phy_mode = dev_read_prop(dev, "phy-mode", NULL);
+	ret = scmi_hailo_configure_ethernet(scmi_agent_dev,
 		tx_bypass_clock_delay, tx_clock_inversion, tx_clock_delay, 
-		rx_bypass_clock_delay, rx_clock_inversion,  rx_clock_delay);
+		rx_bypass_clock_delay, rx_clock_inversion,  rx_clock_delay,
+		strcmp(phy_mode, "rmii") == 0);
 
 	if (ret) {
 		/* If ret value is SCMI_NOT_SUPPORTED, enabling CONFIG_SCMI_HAILO in Kconfig might solve the problem. */
-		printf("Error configuring ethernet delay: ret=%d\n", ret);
+		printf("Error configuring ethernet: ret=%d\n", ret);
 		return ret;
 	}
 
-	phy_mode = dev_read_prop(dev, "phy-mode", NULL);
-	if (strcmp(phy_mode, "rmii") == 0) {
-		ret = scmi_hailo_set_eth_rmii(scmi_agent_dev);
-		if (ret) {
-			/* If ret value is SCMI_NOT_SUPPORTED, enabling CONFIG_SCMI_HAILO in Kconfig might solve the problem. */
-			printf("Error setting rmii mode: ret=%d\n", ret);
-			return ret;
-		}
-	}
-
 	ret = clk_get_by_name(dev, "pclk", &clk);
 	if (ret)
 		return ret;
@@ -1072,8 +1213,8 @@ static int _macb_init(struct macb_device *macb, const char *name)
 
 	/* initialize DMA descriptors */
 	paddr = macb->rx_buffer_dma;
-	for (i = 0; i < MACB_RX_RING_SIZE; i++) {
-		if (i == (MACB_RX_RING_SIZE - 1))
+	for (i = 0; i < macb->rx_ring_size; i++) {
+		if (i == (macb->rx_ring_size - 1))
 			paddr |= MACB_BIT(RX_WRAP);
 		if (macb->config->hw_dma_cap & HW_DMA_CAP_64B)
 			count = i * 2;
@@ -1086,13 +1227,13 @@ static int _macb_init(struct macb_device *macb, const char *name)
 	macb_flush_ring_desc(macb, RX);
 	macb_flush_rx_buffer(macb);
 
-	for (i = 0; i < MACB_TX_RING_SIZE; i++) {
+	for (i = 0; i < macb->tx_ring_size; i++) {
 		if (macb->config->hw_dma_cap & HW_DMA_CAP_64B)
 			count = i * 2;
 		else
 			count = i;
 		macb_set_addr(macb, &macb->tx_ring[count], 0);
-		if (i == (MACB_TX_RING_SIZE - 1))
+		if (i == (macb->tx_ring_size - 1))
 			macb->tx_ring[count].ctrl = MACB_BIT(TX_USED) |
 				MACB_BIT(TX_WRAP);
 		else
@@ -1122,6 +1263,12 @@ static int _macb_init(struct macb_device *macb, const char *name)
 		/* Check the multi queue and initialize the queue for tx */
 		gmac_init_multi_queues(macb);
 
+#ifdef CONFIG_MACB_JUMBO_FRAMES
+		gem_writel(macb, JML, CONFIG_MACB_JUMBO_MAX_LEN);
+		macb_writel(macb, NCFGR,
+			    macb_readl(macb, NCFGR) | MACB_BIT(JFRAME));
+#endif
+
 		/*
 		 * When the GMAC IP with GE feature, this bit is used to
 		 * select interface between RGMII and GMII.
@@ -1220,6 +1367,15 @@ static void _macb_halt(struct macb_device *macb)
 		tsr = macb_readl(macb, TSR);
 	} while (tsr & MACB_BIT(TGO));
 
+	/* Keep the error counters before they are cleared */
+	if (macb_is_gem(macb)) {
+		macb->stats.rx_overruns += gem_readl(macb, RXORCNT);
+		macb->stats.rx_resource_errors += gem_readl(macb, RXRESERRCNT);
+	} else {
+		macb->stats.rx_overruns += macb_readl(macb, ROVR);
+		macb->stats.rx_resource_errors += macb_readl(macb, RRE);
+	}
+
 	/* Disable TX and RX, and clear statistics */
 	macb_writel(macb, NCR, MACB_BIT(CLRSTAT));
 
@@ -1315,24 +1471,47 @@ static u32 macb_dbw(struct macb_device *macb)
 	}
 }
 
-static void _macb_eth_initialize(struct macb_device *macb)
+static int _macb_eth_initialize(struct macb_device *macb)
 {
 	int id = 0;	/* This is not used by functions we call */
+	unsigned int wrap_len = PKTSIZE_ALIGN;
 	u32 ncfgr;
 
-	if (macb_is_gem(macb))
-		macb->rx_buffer_size = GEM_RX_BUFFER_SIZE;
-	else
-		macb->rx_buffer_size = MACB_RX_BUFFER_SIZE;
+	if (!macb->rx_buffer_size) {
+		if (macb_is_gem(macb))
+			macb->rx_buffer_size = GEM_RX_BUFFER_SIZE;
+		else
+			macb->rx_buffer_size = MACB_RX_BUFFER_SIZE;
+	}
+	if (!macb->rx_ring_size)
+		macb->rx_ring_size = MACB_RX_RING_SIZE;
+	if (!macb->tx_ring_size)
+		macb->tx_ring_size = MACB_TX_RING_SIZE;
+
+	macb->rx_frmlen_mask = RXBUF_FRMLEN_MASK;
+#ifdef CONFIG_MACB_JUMBO_FRAMES
+	if (macb_is_gem(macb)) {
+		macb->rx_frmlen_mask = RXBUF_JFRMLEN_MASK;
+		wrap_len = CONFIG_MACB_JUMBO_MAX_LEN;
+	}
+#endif
+	/* Frames wrapping around the RX ring are reassembled here */
+	macb->rx_wrap_buffer = memalign(ARCH_DMA_MINALIGN, wrap_len);
+	if (!macb->rx_wrap_buffer)
+		return -ENOMEM;
 
 	/* TODO: we need check the rx/tx_ring_dma is dcache line aligned */
 	macb->rx_buffer = dma_alloc_coherent(macb->rx_buffer_size *
-					     MACB_RX_RING_SIZE,
+					     macb->rx_ring_size,
 					     &macb->rx_buffer_dma);
-	macb->rx_ring = dma_alloc_coherent(MACB_RX_DMA_DESC_SIZE,
+	macb->rx_ring = dma_alloc_coherent(MACB_RX_DMA_DESC_SIZE(macb),
 					   &macb->rx_ring_dma);
-	macb->tx_ring = dma_alloc_coherent(MACB_TX_DMA_DESC_SIZE,
+	macb->tx_ring = dma_alloc_coherent(MACB_TX_DMA_DESC_SIZE(macb),
 					   &macb->tx_ring_dma);
+#ifdef CONFIG_MACB_ASYNC_TX
+	macb->tx_buffer = dma_alloc_coherent(PKTSIZE_ALIGN * macb->tx_ring_size,
+					     &macb->tx_buffer_dma);
+#endif
 	macb->dummy_desc = dma_alloc_coherent(MACB_TX_DUMMY_DMA_DESC_SIZE,
 					   &macb->dummy_desc_dma);
 
@@ -1348,6 +1527,8 @@ static void _macb_eth_initialize(struct macb_device *macb)
 	}
 
 	macb_writel(macb, NCFGR, ncfgr);
+
+	return 0;
 }
 
 #ifndef CONFIG_DM_ETH
@@ -1364,6 +1545,9 @@ static int macb_recv(struct eth_device *netdev)
 	uchar *packet;
 	int length;
 
+#ifdef CONFIG_MACB_ASYNC_TX
+	macb_tx_reclaim(macb, netdev->name);
+#endif
 	macb->wrapped = false;
 	for (;;) {
 		macb->next_rx_tail = macb->rx_tail;
@@ -1426,7 +1610,11 @@ int macb_eth_initialize(int id, void *regs, unsigned int phy_addr)
 	netdev->recv = macb_recv;
 	netdev->write_hwaddr = macb_write_hwaddr;
 
-	_macb_eth_initialize(macb);
+	if (_macb_eth_initialize(macb)) {
+		printf("Error: Failed to allocate memory for MACB%d\n", id);
+		free(macb);
+		return -ENOMEM;
+	}
 
 	eth_register(netdev);
 
@@ -1478,6 +1666,9 @@ static int macb_recv(struct udevice *dev, int flags, uchar **packetp)
 {
 	struct macb_device *macb = dev_get_priv(dev);
 
+#ifdef CONFIG_MACB_ASYNC_TX
+	macb_tx_reclaim(macb, dev->name);
+#endif
 	macb->next_rx_tail = macb->rx_tail;
 	macb->wrapped = false;
 
@@ -1597,6 +1788,19 @@ static int macb_eth_probe(struct udevice *dev)
 
 	macb->regs = (void *)(uintptr_t)pdata->iobase;
 
+	macb->rx_ring_size = dev_read_u32_default(dev, "cdns,rx-ring-size",
+						  MACB_RX_RING_SIZE);
+	macb->tx_ring_size = dev_read_u32_default(dev, "cdns,tx-ring-size",
+						  MACB_TX_RING_SIZE);
+	macb->rx_buffer_size = dev_read_u32_default(dev, "cdns,rx-buffer-size",
+						    0);
+	if (macb->rx_ring_size < 2 || macb->tx_ring_size < 2 ||
+	    macb->rx_ring_size % DESC_PER_CACHELINE_32 ||
+	    macb->rx_buffer_size % RX_BUFFER_MULTIPLE) {
+		debug("%s: Invalid ring or buffer size\n", __func__);
+		return -EINVAL;
+	}
+
 	macb->is_big_endian = (cpu_to_be32(0x12345678) == 0x12345678);
 
 	macb->config = (struct macb_config *)dev_get_driver_data(dev);
@@ -1614,7 +1818,9 @@ static int macb_eth_probe(struct udevice *dev)
 		return ret;
 #endif
 
-	_macb_eth_initialize(macb);
+	ret = _macb_eth_initialize(macb);
+	if (ret)
+		return ret;
 
 #if defined(CONFIG_CMD_MII) || defined(CONFIG_PHYLIB)
 	macb->bus = mdio_alloc();
@@ -1743,6 +1949,61 @@ U_BOOT_DRIVER(eth_macb) = {
 	.priv_auto	= sizeof(struct macb_device),
 	.plat_auto	= sizeof(struct eth_pdata),
 };
+
+#ifdef CONFIG_CMD_MACB
+static int do_macb_stats(struct cmd_tbl *cmdtp, int flag, int argc,
+			 char *const argv[])
+{
+	struct macb_device *macb;
+	struct udevice *dev;
+	struct uclass *uc;
+
+	uclass_id_foreach_dev(UCLASS_ETH, dev, uc) {
+		if (dev->driver != DM_DRIVER_GET(eth_macb) ||
+		    !device_active(dev))
+			continue;
+		if (argc > 1 && strcmp(argv[1], dev->name))
+			continue;
+
+		macb = dev_get_priv(dev);
+		printf("%s: rx ring %u x %zu bytes, tx ring %u\n", dev->name,
+		       macb->rx_ring_size, macb->rx_buffer_size,
+		       macb->tx_ring_size);
+		printf("  rx overrun:        %lu\n", macb->stats.rx_overruns);
+		printf("  rx resource error: %lu\n",
+		       macb->stats.rx_resource_errors);
+		printf("  tx ring full:      %lu\n", macb->stats.tx_ring_full);
+	}
+
+	return CMD_RET_SUCCESS;
+}
+
+static struct cmd_tbl cmd_macb_sub[] = {
+	U_BOOT_CMD_MKENT(stats, 2, 0, do_macb_stats, "", ""),
+};
+
+static int do_macb(struct cmd_tbl *cmdtp, int flag, int argc,
+		   char *const argv[])
+{
+	struct cmd_tbl *cp;
+
+	if (argc < 2)
+		return CMD_RET_USAGE;
+
+	cp = find_cmd_tbl(argv[1], cmd_macb_sub, ARRAY_SIZE(cmd_macb_sub));
+	if (!cp)
+		return CMD_RET_USAGE;
+
+	return cp->cmd(cmdtp, flag, argc - 1, argv + 1);
+}
+
+U_BOOT_CMD(
+	macb, 3, 0, do_macb,
+	"Cadence MACB/GEM controller management",
+	"stats [<dev>] - show RX overrun and ring full counters\n"
+	"       Counters are updated each time the interface is stopped"
+);
+#endif
 #endif
 
 #endif
@@ -54,8 +54,11 @@ static int cadence_spi_read_id(struct cadence_spi_plat *plat, u8 len,
 	return cadence_qspi_apb_command_read(plat, &op);
 }
 
-/* Calibration sequence to determine the read data capture delay register */
-static int spi_calibration(struct udevice *bus, uint hz)
+/*
+ * Calibration sequence to determine the read data capture delay register,
+ * against the flash on chip select @cs
+ */
+static int spi_calibration(struct udevice *bus, uint hz, unsigned int cs)
 {
 	struct cadence_spi_priv *priv = dev_get_priv(bus);
 	struct cadence_spi_plat *plat = dev_get_plat(bus);
@@ -69,6 +72,8 @@ static int spi_calibration(struct udevice *bus, uint hz)
 	/* configure the read data capture delay register to 0 */
 	cadence_qspi_apb_readdata_capture(base, 1, 0);
 
+	cadence_qspi_apb_chipselect(base, cs, plat->is_decoded_cs);
+
 	/* Enable QSPI */
 	cadence_qspi_apb_controller_enable(base);
 
@@ -127,7 +132,7 @@ static int spi_calibration(struct udevice *bus, uint hz)
 
 	/* just to ensure we do once only when speed or chip select change */
 	priv->qspi_calibrated_hz = hz;
-	priv->qspi_calibrated_cs = spi_chip_select(bus);
+	priv->qspi_calibrated_cs = cs;
 
 	return 0;
 }
@@ -136,7 +141,6 @@ static int cadence_spi_set_speed(struct udevice *bus, uint hz)
 {
 	struct cadence_spi_plat *plat = dev_get_plat(bus);
 	struct cadence_spi_priv *priv = dev_get_priv(bus);
-	int err;
 
 	if (hz > plat->max_hz)
 		hz = plat->max_hz;
@@ -152,21 +156,11 @@ static int cadence_spi_set_speed(struct udevice *bus, uint hz)
 		cadence_spi_write_speed(bus, hz);
 		cadence_qspi_apb_readdata_capture(priv->regbase, 1,
 						  plat->read_delay);
-	} else if (priv->previous_hz != hz ||
-		   priv->qspi_calibrated_hz != hz ||
-		   priv->qspi_calibrated_cs != spi_chip_select(bus)) {
-		/*
-		 * Calibration required for different current SCLK speed,
-		 * requested SCLK speed or chip select
-		 */
-		err = spi_calibration(bus, hz);
-		if (err)
-			return err;
-
-		/* prevent calibration run when same as previous request */
-		priv->previous_hz = hz;
 	}
 
+	/* Calibration needs the chip select, it is left to claim_bus() */
+	priv->previous_hz = hz;
+
 	/* Enable QSPI */
 	cadence_qspi_apb_controller_enable(priv->regbase);
 
@@ -175,6 +169,32 @@ static int cadence_spi_set_speed(struct udevice *bus, uint hz)
 	return 0;
 }
 
+static int cadence_spi_claim_bus(struct udevice *dev)
+{
+	struct udevice *bus = dev_get_parent(dev);
+	struct cadence_spi_plat *plat = dev_get_plat(bus);
+	struct cadence_spi_priv *priv = dev_get_priv(bus);
+	unsigned int cs = spi_chip_select(dev);
+	int err;
+
+	/*
+	 * Calibration required for different requested SCLK speed or chip
+	 * select
+	 */
+	if (plat->read_delay >= 0 ||
+	    (priv->qspi_calibrated_hz == priv->previous_hz &&
+	     priv->qspi_calibrated_cs == cs))
+		return 0;
+
+	cadence_qspi_apb_controller_disable(priv->regbase);
+	err = spi_calibration(bus, priv->previous_hz, cs);
+	if (err)
+		return err;
+	cadence_qspi_apb_controller_enable(priv->regbase);
+
+	return 0;
+}
+
 static int cadence_spi_probe(struct udevice *bus)
 {
 	struct cadence_spi_plat *plat = dev_get_plat(bus);
@@ -380,6 +400,7 @@ static const struct spi_controller_mem_ops cadence_spi_mem_ops = {
 };
 
 static const struct dm_spi_ops cadence_spi_ops = {
+	.claim_bus	= cadence_spi_claim_bus,
 	.set_speed	= cadence_spi_set_speed,
 	.set_mode	= cadence_spi_set_mode,
 	.mem_ops	= &cadence_spi_mem_ops,
@@ -27,11 +27,13 @@
 
 #include <common.h>
 #include <log.h>
+#include <asm/cache.h>
 #include <asm/io.h>
 #include <dma.h>
 #include <linux/bitops.h>
 #include <linux/delay.h>
 #include <linux/errno.h>
+#include <linux/log2.h>
 #include <wait_bit.h>
 #include <spi.h>
 #include <spi-mem.h>
@@ -166,6 +168,8 @@
 #define	CQSPI_REG_INDIRECTWRSTARTADDR		0x78
 #define	CQSPI_REG_INDIRECTWRBYTES		0x7C
 
+#define	CQSPI_REG_INDIRECTTRIGGERADDRRANGE	0x80
+
 #define	CQSPI_REG_CMDADDRESS			0x94
 #define	CQSPI_REG_CMDREADDATALOWER		0xA0
 #define	CQSPI_REG_CMDREADDATAUPPER		0xA4
@@ -789,14 +793,16 @@ static u32 cadence_qspi_get_rd_sram_level(struct cadence_spi_plat *plat)
 	return reg & CQSPI_REG_SDRAMLEVEL_RD_MASK;
 }
 
-static int cadence_qspi_wait_for_data(struct cadence_spi_plat *plat)
+/* Wait until at least @level words are in the read partition of the SRAM */
+static int cadence_qspi_wait_for_level(struct cadence_spi_plat *plat,
+				       u32 level)
 {
 	unsigned int timeout = 10000;
 	u32 reg;
 
 	while (timeout--) {
 		reg = cadence_qspi_get_rd_sram_level(plat);
-		if (reg)
+		if (reg >= level)
 			return reg;
 		udelay(1);
 	}
@@ -804,9 +810,50 @@ static int cadence_qspi_wait_for_data(struct cadence_spi_plat *plat)
 	return -ETIMEDOUT;
 }
 
+static int cadence_qspi_wait_for_data(struct cadence_spi_plat *plat)
+{
+	return cadence_qspi_wait_for_level(plat, 1);
+}
+
+#if IS_ENABLED(CONFIG_CADENCE_QSPI_INDIRECT_DMA)
+/*
+ * Return the number of bytes to copy out of the SRAM per DMA transfer, or
+ * 0 to drain it with the CPU. A burst is half the read partition, so the
+ * controller keeps filling one half while the other half is copied.
+ */
+static unsigned int cadence_qspi_dma_burst(struct cadence_spi_plat *plat,
+					   unsigned int n_rx, u8 *rxbuf)
+{
+	unsigned int burst = plat->fifo_depth / 2 * plat->fifo_width / 2;
+	struct udevice *dev;
+
+	if (!burst || burst % ARCH_DMA_MINALIGN || n_rx < burst ||
+	    !IS_ALIGNED((uintptr_t)rxbuf, ARCH_DMA_MINALIGN))
+		return 0;
+
+	if (dma_get_device(DMA_SUPPORTS_MEM_TO_MEM, &dev))
+		return 0;
+
+	/* A burst reads incrementing addresses, all of them must hit the SRAM */
+	writel(ilog2(roundup_pow_of_two(burst)),
+	       plat->regbase + CQSPI_REG_INDIRECTTRIGGERADDRRANGE);
+	writel(burst, plat->regbase + CQSPI_REG_INDIRECTRDWATERMARK);
+
+	return burst;
+}
+#else
+static inline unsigned int
+cadence_qspi_dma_burst(struct cadence_spi_plat *plat, unsigned int n_rx,
+		       u8 *rxbuf)
+{
+	return 0;
+}
+#endif
+
 static int
-cadence_qspi_apb_indirect_read_execute(struct cadence_spi_plat *plat,
-				       unsigned int n_rx, u8 *rxbuf)
+cadence_qspi_apb_indirect_read_xfer(struct cadence_spi_plat *plat,
+				    unsigned int n_rx, u8 *rxbuf,
+				    unsigned int burst)
 {
 	unsigned int remaining = n_rx;
 	unsigned int bytes_to_read = 0;
@@ -819,6 +866,25 @@ cadence_qspi_apb_indirect_read_execute(struct cadence_spi_plat *plat,
 	       plat->regbase + CQSPI_REG_INDIRECTRD);
 
 	while (remaining > 0) {
+		if (burst && remaining >= burst) {
+			ret = cadence_qspi_wait_for_level(plat,
+						burst / plat->fifo_width);
+			if (ret < 0) {
+				printf("Indirect read timed out (%i)\n", ret);
+				goto failrd;
+			}
+
+			ret = dma_memcpy(rxbuf, plat->ahbbase, burst);
+			if (ret < 0) {
+				/* Finish the transfer with the CPU */
+				burst = 0;
+				continue;
+			}
+			rxbuf += burst;
+			remaining -= burst;
+			continue;
+		}
+
 		ret = cadence_qspi_wait_for_data(plat);
 		if (ret < 0) {
 			printf("Indirect write timed out (%i)\n", ret);
@@ -875,6 +941,34 @@ failrd:
 	return ret;
 }
 
+static int
+cadence_qspi_apb_indirect_read_execute(struct cadence_spi_plat *plat,
+				       unsigned int n_rx, u8 *rxbuf)
+{
+	u32 trigger_range = 0, watermark = 0;
+	unsigned int burst;
+	int ret;
+
+	/* A DMA burst reprograms these, put them back for the next reads */
+	if (IS_ENABLED(CONFIG_CADENCE_QSPI_INDIRECT_DMA)) {
+		trigger_range = readl(plat->regbase +
+				      CQSPI_REG_INDIRECTTRIGGERADDRRANGE);
+		watermark = readl(plat->regbase +
+				  CQSPI_REG_INDIRECTRDWATERMARK);
+	}
+
+	burst = cadence_qspi_dma_burst(plat, n_rx, rxbuf);
+	ret = cadence_qspi_apb_indirect_read_xfer(plat, n_rx, rxbuf, burst);
+
+	if (burst) {
+		writel(trigger_range,
+		       plat->regbase + CQSPI_REG_INDIRECTTRIGGERADDRRANGE);
+		writel(watermark, plat->regbase + CQSPI_REG_INDIRECTRDWATERMARK);
+	}
+
+	return ret;
+}
+
 int cadence_qspi_apb_read_execute(struct cadence_spi_plat *plat,
 				  const struct spi_mem_op *op)
 {
@@ -201,6 +201,405 @@ out:
 
 	return ret;
 }
+#elif defined(CONFIG_ENV_SPI_LOG)
+/*
+ * The environment area holds a log of records. The first one is a snapshot
+ * of the whole environment, every following one only lists the variables
+ * that changed since, as "name=value" or "name=" for a deleted variable.
+ * Entries are sorted by name, as exported by hexport_r(), so records can be
+ * merged and compared in a single pass. saveenv appends a record to the
+ * erased space after the log, and only erases the area to write a fresh
+ * snapshot when the log is full or damaged.
+ */
+#define ENV_SF_LOG_MAGIC	0x4c564e45	/* "ENVL" */
+#define ENV_SF_LOG_SNAPSHOT	1
+#define ENV_SF_LOG_DELTA	2
+
+struct env_sf_log_rec {
+	u32	magic;		/* ENV_SF_LOG_MAGIC */
+	u32	type;		/* ENV_SF_LOG_SNAPSHOT or ENV_SF_LOG_DELTA */
+	u32	len;		/* length of the entries that follow */
+	u32	crc;		/* crc32 of type, len and the entries */
+	char	text[];
+};
+
+#define ENV_SF_LOG_REC_SIZE(len) \
+	ALIGN(sizeof(struct env_sf_log_rec) + (len), 4)
+
+static u32 env_sf_log_crc(const struct env_sf_log_rec *rec)
+{
+	u32 crc;
+
+	crc = crc32(0, (const u8 *)&rec->type,
+		    sizeof(rec->type) + sizeof(rec->len));
+
+	return crc32(crc, (const u8 *)rec->text, rec->len);
+}
+
+/* Compare the names of two "name=value" entries */
+static int env_sf_log_cmp(const char *a, const char *b)
+{
+	while (*a == *b && *a && *a != '=') {
+		a++;
+		b++;
+	}
+
+	return (*a == '=' ? 0 : (u8)*a) - (*b == '=' ? 0 : (u8)*b);
+}
+
+static bool env_sf_log_is_delete(const char *entry)
+{
+	const char *eq = strchr(entry, '=');
+
+	return !eq || !eq[1];
+}
+
+static int env_sf_log_put(char *out, int pos, int size, const char *entry,
+			  int len)
+{
+	if (pos + len > size)
+		return -ENOSPC;
+	memcpy(out + pos, entry, len);
+
+	return pos + len;
+}
+
+/*
+ * Apply the changes in @delta to the entries in @old, writing the result to
+ * @out. Return the length of the result or -ENOSPC.
+ */
+static int env_sf_log_merge(const char *old, int old_len, const char *delta,
+			    int delta_len, char *out, int size)
+{
+	const char *old_end = old + old_len, *delta_end = delta + delta_len;
+	int pos = 0, olen, dlen, cmp;
+
+	while (pos >= 0 && (old < old_end || delta < delta_end)) {
+		olen = old < old_end ? strlen(old) + 1 : 0;
+		dlen = delta < delta_end ? strlen(delta) + 1 : 0;
+		if (!dlen)
+			cmp = -1;
+		else if (!olen)
+			cmp = 1;
+		else
+			cmp = env_sf_log_cmp(old, delta);
+
+		if (cmp < 0) {
+			pos = env_sf_log_put(out, pos, size, old, olen);
+			old += olen;
+			continue;
+		}
+		if (!cmp)
+			old += olen;
+		if (!env_sf_log_is_delete(delta))
+			pos = env_sf_log_put(out, pos, size, delta, dlen);
+		delta += dlen;
+	}
+
+	return pos;
+}
+
+/*
+ * Write to @out the changes that turn the entries in @old into those in
+ * @new. Return the length of the changes or -ENOSPC.
+ */
+static int env_sf_log_diff(const char *old, int old_len, const char *new,
+			   int new_len, char *out, int size)
+{
+	const char *old_end = old + old_len, *new_end = new + new_len;
+	int pos = 0, olen, nlen, cmp;
+
+	while (pos >= 0 && (old < old_end || new < new_end)) {
+		olen = old < old_end ? strlen(old) + 1 : 0;
+		nlen = new < new_end ? strlen(new) + 1 : 0;
+		if (!nlen)
+			cmp = -1;
+		else if (!olen)
+			cmp = 1;
+		else
+			cmp = env_sf_log_cmp(old, new);
+
+		if (cmp < 0) {
+			/* deleted, record "name=" */
+			pos = env_sf_log_put(out, pos, size, old,
+					     strchr(old, '=') - old + 1);
+			if (pos >= 0)
+				pos = env_sf_log_put(out, pos, size, "", 1);
+		} else if (cmp > 0 || strcmp(old, new)) {
+			pos = env_sf_log_put(out, pos, size, new, nlen);
+		}
+		if (cmp <= 0)
+			old += olen;
+		if (cmp >= 0)
+			new += nlen;
+	}
+
+	return pos;
+}
+
+/* Length of the entries in exported environment data, without the final NUL */
+static int env_sf_log_text_len(const char *data, int size)
+{
+	int pos = 0;
+
+	while (pos < size && data[pos])
+		pos += strnlen(data + pos, size - pos) + 1;
+
+	return min(pos, size);
+}
+
+/*
+ * Replay the log in @area into the data of @env, using @tmp as scratch
+ * space of ENV_SIZE bytes. Return the offset of the end of the log, or
+ * -EINVAL if the area does not start with a valid snapshot.
+ */
+static int env_sf_log_replay(const char *area, env_t *env, char *tmp)
+{
+	const struct env_sf_log_rec *rec;
+	int pos = 0, len = 0, ret;
+
+	memset(env->data, 0, ENV_SIZE);
+	while (pos + sizeof(*rec) <= CONFIG_ENV_SIZE) {
+		rec = (const struct env_sf_log_rec *)(area + pos);
+		if (rec->magic != ENV_SF_LOG_MAGIC ||
+		    rec->len > CONFIG_ENV_SIZE - pos - sizeof(*rec) ||
+		    (rec->len && rec->text[rec->len - 1]) ||
+		    rec->crc != env_sf_log_crc(rec))
+			break;
+
+		if (rec->type == ENV_SF_LOG_SNAPSHOT && !pos) {
+			if (rec->len >= ENV_SIZE)
+				break;
+			memcpy(env->data, rec->text, rec->len);
+			len = rec->len;
+		} else if (rec->type == ENV_SF_LOG_DELTA && pos) {
+			ret = env_sf_log_merge((char *)env->data, len,
+					       rec->text, rec->len, tmp,
+					       ENV_SIZE - 1);
+			if (ret < 0)
+				break;
+			memcpy(env->data, tmp, ret);
+			memset(env->data + ret, 0, ENV_SIZE - ret);
+			len = ret;
+		} else {
+			break;
+		}
+		pos += ENV_SF_LOG_REC_SIZE(rec->len);
+	}
+
+	if (!pos)
+		return -EINVAL;
+
+	env->crc = crc32(0, env->data, ENV_SIZE);
+
+	return pos;
+}
+
+/* Check that a record of @size bytes fits in the erased space at @pos */
+static bool env_sf_log_fits(const char *area, int pos, int size)
+{
+	int i;
+
+	if (pos + size > CONFIG_ENV_SIZE)
+		return false;
+
+	for (i = pos; i < CONFIG_ENV_SIZE; i++)
+		if (area[i] != (char)0xff)
+			return false;
+
+	return true;
+}
+
+/* Erase the environment area and write @rec as its only record */
+static int env_sf_log_compact(struct spi_flash *env_flash,
+			      struct env_sf_log_rec *rec)
+{
+	u32	saved_size = 0, saved_offset = 0, sector;
+	u32	sect_size = CONFIG_ENV_SECT_SIZE;
+	char	*saved_buffer = NULL;
+	int	ret;
+
+	if (IS_ENABLED(CONFIG_ENV_SECT_SIZE_AUTO))
+		sect_size = env_flash->mtd.erasesize;
+
+	/* Is the sector larger than the env (i.e. embedded) */
+	if (sect_size > CONFIG_ENV_SIZE) {
+		saved_size = sect_size - CONFIG_ENV_SIZE;
+		saved_offset = env_sf_get_env_offset() + CONFIG_ENV_SIZE;
+		saved_buffer = malloc(saved_size);
+		if (!saved_buffer)
+			return -ENOMEM;
+
+		ret = spi_flash_read(env_flash, saved_offset,
+			saved_size, saved_buffer);
+		if (ret)
+			goto done;
+	}
+
+	sector = DIV_ROUND_UP(CONFIG_ENV_SIZE, sect_size);
+
+	puts("Erasing SPI flash...");
+	ret = spi_flash_erase(env_flash, env_sf_get_env_offset(),
+		sector * sect_size);
+	if (ret)
+		goto done;
+
+	puts("Writing to SPI flash...");
+	ret = spi_flash_write(env_flash, env_sf_get_env_offset(),
+		ENV_SF_LOG_REC_SIZE(rec->len), rec);
+	if (ret)
+		goto done;
+
+	if (sect_size > CONFIG_ENV_SIZE)
+		ret = spi_flash_write(env_flash, saved_offset,
+			saved_size, saved_buffer);
+
+done:
+	free(saved_buffer);
+
+	return ret;
+}
+
+static int env_sf_save(void)
+{
+	struct env_sf_log_rec *rec = NULL;
+	env_t	*env_new = NULL, *env_old = NULL;
+	char	*area = NULL;
+	int	old_len, new_len, pos, ret;
+	struct spi_flash *env_flash;
+
+	ret = setup_flash_device(&env_flash);
+	if (ret)
+		return ret;
+
+	area = memalign(ARCH_DMA_MINALIGN, CONFIG_ENV_SIZE);
+	env_new = malloc(sizeof(*env_new));
+	env_old = malloc(sizeof(*env_old));
+	rec = memalign(ARCH_DMA_MINALIGN, ENV_SF_LOG_REC_SIZE(ENV_SIZE));
+	if (!area || !env_new || !env_old || !rec) {
+		ret = -ENOMEM;
+		goto done;
+	}
+
+	ret = env_export(env_new);
+	if (ret) {
+		ret = -EIO;
+		goto done;
+	}
+	new_len = env_sf_log_text_len((char *)env_new->data, ENV_SIZE);
+
+	ret = spi_flash_read(env_flash, env_sf_get_env_offset(),
+			     CONFIG_ENV_SIZE, area);
+	if (ret)
+		goto done;
+
+	/* Append the changes if the log is intact and has room for them */
+	pos = env_sf_log_replay(area, env_old, rec->text);
+	if (pos > 0) {
+		old_len = env_sf_log_text_len((char *)env_old->data, ENV_SIZE);
+		ret = env_sf_log_diff((char *)env_old->data, old_len,
+				      (char *)env_new->data, new_len,
+				      rec->text, ENV_SIZE);
+		if (!ret) {
+			puts("No changes...");
+			goto out;
+		}
+		if (ret > 0 &&
+		    env_sf_log_fits(area, pos, ENV_SF_LOG_REC_SIZE(ret))) {
+			rec->magic = ENV_SF_LOG_MAGIC;
+			rec->type = ENV_SF_LOG_DELTA;
+			rec->len = ret;
+			memset(rec->text + ret, 0,
+			       ENV_SF_LOG_REC_SIZE(ret) - sizeof(*rec) - ret);
+			rec->crc = env_sf_log_crc(rec);
+
+			puts("Writing to SPI flash...");
+			ret = spi_flash_write(env_flash,
+					      env_sf_get_env_offset() + pos,
+					      ENV_SF_LOG_REC_SIZE(rec->len),
+					      rec);
+			if (ret)
+				goto done;
+			goto out;
+		}
+	}
+
+	/* Start a new log with a snapshot */
+	if (ENV_SF_LOG_REC_SIZE(new_len) > CONFIG_ENV_SIZE) {
+		puts("Environment too large for the log\n");
+		ret = -ENOSPC;
+		goto done;
+	}
+	rec->magic = ENV_SF_LOG_MAGIC;
+	rec->type = ENV_SF_LOG_SNAPSHOT;
+	rec->len = new_len;
+	memcpy(rec->text, env_new->data, new_len);
+	memset(rec->text + new_len, 0,
+	       ENV_SF_LOG_REC_SIZE(new_len) - sizeof(*rec) - new_len);
+	rec->crc = env_sf_log_crc(rec);
+
+	ret = env_sf_log_compact(env_flash, rec);
+	if (ret)
+		goto done;
+
+out:
+	ret = 0;
+	puts("done\n");
+
+done:
+	spi_flash_free(env_flash);
+
+	free(rec);
+	free(env_old);
+	free(env_new);
+	free(area);
+
+	return ret;
+}
+
+static int env_sf_load(void)
+{
+	int ret;
+	char *buf = NULL, *area = NULL, *tmp = NULL;
+	struct spi_flash *env_flash;
+
+	buf = (char *)memalign(ARCH_DMA_MINALIGN, CONFIG_ENV_SIZE);
+	area = (char *)memalign(ARCH_DMA_MINALIGN, CONFIG_ENV_SIZE);
+	tmp = malloc(ENV_SIZE);
+	if (!buf || !area || !tmp) {
+		env_set_default("malloc() failed", 0);
+		ret = -EIO;
+		goto out;
+	}
+
+	ret = setup_flash_device(&env_flash);
+	if (ret)
+		goto out;
+
+	ret = spi_flash_read(env_flash,
+		env_sf_get_env_offset(), CONFIG_ENV_SIZE, area);
+	if (ret) {
+		env_set_default("spi_flash_read() failed", 0);
+		goto err_read;
+	}
+
+	/* Fall back to a plain environment, as written without the log */
+	if (env_sf_log_replay(area, (env_t *)buf, tmp) < 0)
+		memcpy(buf, area, CONFIG_ENV_SIZE);
+
+	ret = env_import(buf, 1, H_EXTERNAL);
+	if (!ret)
+		gd->env_valid = ENV_VALID;
+
+err_read:
+	spi_flash_free(env_flash);
+out:
+	free(tmp);
+	free(area);
+	free(buf);
+
+	return ret;
+}
 #else
 static int env_sf_save(void)
 {
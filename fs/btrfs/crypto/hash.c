@@ -6,18 +6,6 @@
 #include <u-boot/sha256.h>
 #include <u-boot/crc.h>
 
-static u32 btrfs_crc32c_table[256];
-
-void btrfs_hash_init(void)
-{
-	static int inited = 0;
-
-	if (!inited) {
-		crc32c_init(btrfs_crc32c_table, 0x82F63B78);
-		inited = 1;
-	}
-}
-
 int hash_sha256(const u8 *buf, size_t length, u8 *out)
 {
 	sha256_context ctx;
@@ -43,13 +31,8 @@ int hash_crc32c(const u8 *buf, size_t length, u8 *out)
 {
 	u32 crc;
 
-	crc = crc32c_cal((u32)~0, (char *)buf, length, btrfs_crc32c_table);
+	crc = crc32c((u32)~0, buf, length);
 	put_unaligned_le32(~crc, out);
 
 	return 0;
 }
-
-u32 crc32c(u32 seed, const void * data, size_t len)
-{
-	return crc32c_cal(seed, data, len, btrfs_crc32c_table);
-}
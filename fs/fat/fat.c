@@ -157,6 +157,220 @@ int flush_dirty_fat_buffer(fsdata *mydata)
 }
 #endif
 
+#ifdef CONFIG_FS_FAT_TABLE_CACHE
+/* One FATBUFBLOCKS window of the FAT held by the table cache */
+struct fat_table_window {
+	int bufnum;		/* window held, -1 if the slot is unused */
+	ulong used;		/* LRU stamp of the last access */
+	__u8 *buf;
+};
+
+/*
+ * Windows of the FAT kept across calls, so that following a fragmented
+ * chain or reading the same file again does not re-read the table. If
+ * the whole FAT fits in CONFIG_FS_FAT_TABLE_CACHE_WHOLE_SIZE it is read
+ * in one request instead and every window is served from that copy.
+ * Any write to the device, through FAT or not, drops the cache.
+ */
+static struct {
+	struct blk_desc *dev;	/* device, NULL if the cache is empty */
+	lbaint_t part_start;	/* start of the partition on dev */
+	unsigned int write_seq;	/* dev->write_seq when the cache was filled */
+	__u8 volume_id[4];	/* volume ID of the file system */
+	__u16 sect_size;	/* sector size the buffers were sized for */
+	__u8 *whole;		/* the whole FAT, NULL if not loaded */
+	bool use_whole;		/* the FAT is small enough to load whole */
+	ulong stamp;		/* LRU clock */
+	ulong hits;
+	ulong misses;
+	struct fat_table_window win[CONFIG_FS_FAT_TABLE_CACHE_WINDOWS];
+} fat_table;
+
+static void fat_table_invalidate(void)
+{
+	int i;
+
+	fat_table.dev = NULL;
+	free(fat_table.whole);
+	fat_table.whole = NULL;
+	for (i = 0; i < CONFIG_FS_FAT_TABLE_CACHE_WINDOWS; i++) {
+		free(fat_table.win[i].buf);
+		fat_table.win[i].buf = NULL;
+		fat_table.win[i].bufnum = -1;
+	}
+}
+
+/* Drop the cache when a different file system is mounted */
+static void fat_table_check_volume(const __u8 volume_id[4])
+{
+	if (memcmp(fat_table.volume_id, volume_id, 4)) {
+		fat_table_invalidate();
+		memcpy(fat_table.volume_id, volume_id, 4);
+	}
+}
+
+/* Start caching the FAT of the current file system */
+static void fat_table_select(fsdata *mydata)
+{
+	fat_table_invalidate();
+	fat_table.dev = cur_dev;
+	fat_table.part_start = cur_part_info.start;
+	fat_table.write_seq = cur_dev->write_seq;
+	fat_table.sect_size = mydata->sect_size;
+	fat_table.use_whole = (u64)mydata->fatlength * mydata->sect_size <=
+			      CONFIG_FS_FAT_TABLE_CACHE_WHOLE_SIZE;
+}
+
+static bool fat_table_selected(fsdata *mydata)
+{
+	return fat_table.dev == cur_dev &&
+	       fat_table.part_start == cur_part_info.start &&
+	       fat_table.write_seq == cur_dev->write_seq &&
+	       fat_table.sect_size == mydata->sect_size;
+}
+
+/* Number of sectors in window @bufnum, the last one may be short */
+static __u32 fat_table_window_blocks(fsdata *mydata, __u32 bufnum)
+{
+	__u32 startblock = bufnum * FATBUFBLOCKS;
+
+	if (startblock + FATBUFBLOCKS > mydata->fatlength)
+		return mydata->fatlength - startblock;
+
+	return FATBUFBLOCKS;
+}
+
+static __u8 *fat_table_get_whole(fsdata *mydata, __u32 bufnum)
+{
+	__u32 windows;
+
+	if (fat_table.whole) {
+		fat_table.hits++;
+		return fat_table.whole + bufnum * FATBUFSIZE;
+	}
+
+	/* Round up so that a short last window can be indexed like the rest */
+	windows = DIV_ROUND_UP(mydata->fatlength, FATBUFBLOCKS);
+	fat_table.whole = malloc_cache_aligned(windows * FATBUFSIZE);
+	if (!fat_table.whole)
+		return NULL;
+
+	fat_table.misses++;
+	if (flush_dirty_fat_buffer(mydata) < 0 ||
+	    disk_read(mydata->fat_sect, mydata->fatlength,
+		      fat_table.whole) < 0) {
+		debug("Error reading FAT blocks\n");
+		free(fat_table.whole);
+		fat_table.whole = NULL;
+		return NULL;
+	}
+
+	return fat_table.whole + bufnum * FATBUFSIZE;
+}
+
+static __u8 *fat_table_get_window(fsdata *mydata, __u32 bufnum)
+{
+	struct fat_table_window *win, *lru = NULL;
+	int i;
+
+	for (i = 0; i < CONFIG_FS_FAT_TABLE_CACHE_WINDOWS; i++) {
+		win = &fat_table.win[i];
+		if (win->bufnum == bufnum) {
+			fat_table.hits++;
+			win->used = ++fat_table.stamp;
+			return win->buf;
+		}
+		if (!lru || win->used < lru->used)
+			lru = win;
+	}
+
+	fat_table.misses++;
+	if (!lru->buf) {
+		lru->buf = malloc_cache_aligned(FATBUFSIZE);
+		if (!lru->buf)
+			return NULL;
+	}
+
+	lru->bufnum = -1;
+	if (flush_dirty_fat_buffer(mydata) < 0 ||
+	    disk_read(mydata->fat_sect + bufnum * FATBUFBLOCKS,
+		      fat_table_window_blocks(mydata, bufnum), lru->buf) < 0) {
+		debug("Error reading FAT blocks\n");
+		return NULL;
+	}
+	lru->bufnum = bufnum;
+	lru->used = ++fat_table.stamp;
+
+	return lru->buf;
+}
+
+/*
+ * Return window @bufnum of the FAT of the current file system, reading it
+ * if it is not cached, or NULL on error.
+ */
+static __u8 *fat_table_get(fsdata *mydata, __u32 bufnum)
+{
+	if (!fat_table_selected(mydata))
+		fat_table_select(mydata);
+
+	if (fat_table.use_whole) {
+		__u8 *buf = fat_table_get_whole(mydata, bufnum);
+
+		if (buf)
+			return buf;
+		/* Not enough memory for the whole FAT, cache windows only */
+		fat_table.use_whole = false;
+	}
+
+	return fat_table_get_window(mydata, bufnum);
+}
+
+/*
+ * Copy window @bufnum, just modified in mydata->fatbuf, into the cache so
+ * that it stays coherent with FAT updates that are not yet written back.
+ */
+static void fat_table_update(fsdata *mydata, __u32 bufnum)
+{
+	int i;
+
+	if (!fat_table_selected(mydata))
+		return;
+
+	if (fat_table.whole) {
+		memcpy(fat_table.whole + bufnum * FATBUFSIZE, mydata->fatbuf,
+		       fat_table_window_blocks(mydata, bufnum) *
+		       mydata->sect_size);
+		return;
+	}
+
+	for (i = 0; i < CONFIG_FS_FAT_TABLE_CACHE_WINDOWS; i++) {
+		if (fat_table.win[i].bufnum == bufnum) {
+			memcpy(fat_table.win[i].buf, mydata->fatbuf,
+			       FATBUFSIZE);
+			return;
+		}
+	}
+}
+
+static void fat_table_print_stats(void)
+{
+	printf("FAT cache:  %lu hits, %lu misses (%s)\n", fat_table.hits,
+	       fat_table.misses, fat_table.whole ? "whole table" : "windows");
+}
+#else
+static inline void fat_table_check_volume(const __u8 volume_id[4])
+{
+}
+
+static inline void fat_table_update(fsdata *mydata, __u32 bufnum)
+{
+}
+
+static inline void fat_table_print_stats(void)
+{
+}
+#endif /* CONFIG_FS_FAT_TABLE_CACHE */
+
 /*
  * Get the entry at index 'entry' in a FAT (12/16/32) table.
  * On failure 0x00 is returned.
@@ -166,6 +380,7 @@ static __u32 get_fatent(fsdata *mydata, __u32 entry)
 	__u32 bufnum;
 	__u32 offset, off8;
 	__u32 ret = 0x00;
+	__u8 *fatbuf;
 
 	if (CHECK_CLUST(entry, mydata->fatsize)) {
 		printf("Error: Invalid FAT entry: 0x%08x\n", entry);
@@ -194,6 +409,16 @@ static __u32 get_fatent(fsdata *mydata, __u32 entry)
 	debug("FAT%d: entry: 0x%08x = %d, offset: 0x%04x = %d\n",
 	       mydata->fatsize, entry, entry, offset, offset);
 
+#ifdef CONFIG_FS_FAT_TABLE_CACHE
+	/* An entry being updated is only current in mydata->fatbuf */
+	if (bufnum == mydata->fatbufnum) {
+		fatbuf = mydata->fatbuf;
+	} else {
+		fatbuf = fat_table_get(mydata, bufnum);
+		if (!fatbuf)
+			return ret;
+	}
+#else
 	/* Read a new block of FAT entries into the cache. */
 	if (bufnum != mydata->fatbufnum) {
 		__u32 getsize = FATBUFBLOCKS;
@@ -217,19 +442,21 @@ static __u32 get_fatent(fsdata *mydata, __u32 entry)
 		}
 		mydata->fatbufnum = bufnum;
 	}
+	fatbuf = mydata->fatbuf;
+#endif
 
 	/* Get the actual entry from the table */
 	switch (mydata->fatsize) {
 	case 32:
-		ret = FAT2CPU32(((__u32 *) mydata->fatbuf)[offset]);
+		ret = FAT2CPU32(((__u32 *)fatbuf)[offset]);
 		break;
 	case 16:
-		ret = FAT2CPU16(((__u16 *) mydata->fatbuf)[offset]);
+		ret = FAT2CPU16(((__u16 *)fatbuf)[offset]);
 		break;
 	case 12:
 		off8 = (offset * 3) / 2;
 		/* fatbut + off8 may be unaligned, read in byte granularity */
-		ret = mydata->fatbuf[off8] + (mydata->fatbuf[off8 + 1] << 8);
+		ret = fatbuf[off8] + (fatbuf[off8 + 1] << 8);
 
 		if (offset & 0x1)
 			ret >>= 4;
@@ -304,6 +531,233 @@ get_cluster(fsdata *mydata, __u32 clustnum, __u8 *buffer, unsigned long size)
 	return 0;
 }
 
+#ifdef CONFIG_FS_FAT_EXTENT_CACHE
+/* A run of consecutive clusters in a cluster chain */
+struct fat_extent {
+	__u32 start;	/* first cluster of the run */
+	__u32 count;	/* number of clusters in the run */
+};
+
+/*
+ * Runs of the cluster chain of the file read last. The table covers the
+ * clusters from index 'base' in the file; a chain with more runs than fit
+ * is cached a window at a time, so a sequential reader walks it only once.
+ * The cache is kept across calls, so chunked readers (file_fat_read_at(),
+ * SPL) do not rewalk the chain from the start for every chunk. Any write
+ * to the device, through FAT or not, drops it.
+ */
+static struct {
+	struct blk_desc *dev;	/* device, NULL if the cache is empty */
+	lbaint_t part_start;	/* start of the partition on dev */
+	unsigned int write_seq;	/* dev->write_seq when the cache was filled */
+	__u8 volume_id[4];	/* volume ID of the file system */
+	__u32 first;		/* first cluster of the file */
+	__u32 base;		/* index in the file of ext[0].start */
+	__u32 clusters;		/* number of clusters in ext[] */
+	bool complete;		/* ext[] reaches the end of the file */
+	int nr;			/* number of entries in ext[] */
+	struct fat_extent ext[CONFIG_FS_FAT_EXTENT_CACHE_SIZE];
+} fat_extents;
+
+static void fat_extents_invalidate(void)
+{
+	fat_extents.dev = NULL;
+}
+
+/* Drop the cache when a different file system is mounted */
+static void fat_extents_check_volume(const __u8 volume_id[4])
+{
+	if (memcmp(fat_extents.volume_id, volume_id, 4)) {
+		fat_extents_invalidate();
+		memcpy(fat_extents.volume_id, volume_id, 4);
+	}
+}
+
+/*
+ * Walk the chain from cluster @clust, which is at index @idx in the file,
+ * and record its runs until the table is full or @needed clusters of the
+ * file are covered.
+ */
+static int fat_extents_fill(fsdata *mydata, __u32 first, __u32 clust,
+			    __u32 idx, __u32 needed)
+{
+	struct fat_extent *ext = fat_extents.ext;
+	__u32 next;
+
+	fat_extents.dev = cur_dev;
+	fat_extents.part_start = cur_part_info.start;
+	fat_extents.write_seq = cur_dev->write_seq;
+	fat_extents.first = first;
+	fat_extents.base = idx;
+	fat_extents.complete = false;
+	fat_extents.nr = 1;
+	fat_extents.clusters = 1;
+	ext->start = clust;
+	ext->count = 1;
+
+	while (idx + fat_extents.clusters < needed) {
+		next = get_fatent(mydata, clust);
+		if (CHECK_CLUST(next, mydata->fatsize)) {
+			debug("curclust: 0x%x\n", next);
+			printf("Invalid FAT entry\n");
+			fat_extents_invalidate();
+			return -1;
+		}
+
+		if (next != clust + 1) {
+			if (fat_extents.nr == CONFIG_FS_FAT_EXTENT_CACHE_SIZE)
+				return 0;
+			ext = &fat_extents.ext[fat_extents.nr++];
+			ext->start = next;
+			ext->count = 0;
+		}
+		ext->count++;
+		fat_extents.clusters++;
+		clust = next;
+	}
+	fat_extents.complete = true;
+
+	return 0;
+}
+
+/*
+ * Find the cluster at index @idx in the file starting at cluster @first,
+ * which has @needed clusters. Also return how many consecutive clusters
+ * start there.
+ */
+static int fat_extents_lookup(fsdata *mydata, __u32 first, __u32 needed,
+			      __u32 idx, __u32 *clust, __u32 *run)
+{
+	struct fat_extent *ext;
+	__u32 next, n;
+	int i;
+
+	if (fat_extents.dev != cur_dev ||
+	    fat_extents.part_start != cur_part_info.start ||
+	    fat_extents.write_seq != cur_dev->write_seq ||
+	    fat_extents.first != first || idx < fat_extents.base) {
+		if (fat_extents_fill(mydata, first, first, 0, needed))
+			return -1;
+	}
+
+	/* Move the window on along the chain */
+	while (idx >= fat_extents.base + fat_extents.clusters) {
+		if (fat_extents.complete)
+			return -1;
+		ext = &fat_extents.ext[fat_extents.nr - 1];
+		next = get_fatent(mydata, ext->start + ext->count - 1);
+		if (CHECK_CLUST(next, mydata->fatsize)) {
+			debug("curclust: 0x%x\n", next);
+			printf("Invalid FAT entry\n");
+			fat_extents_invalidate();
+			return -1;
+		}
+		if (fat_extents_fill(mydata, first, next,
+				     fat_extents.base + fat_extents.clusters,
+				     needed))
+			return -1;
+	}
+
+	n = fat_extents.base;
+	for (i = 0; i < fat_extents.nr; i++) {
+		ext = &fat_extents.ext[i];
+		if (idx < n + ext->count) {
+			*clust = ext->start + idx - n;
+			*run = ext->count - (idx - n);
+			return 0;
+		}
+		n += ext->count;
+	}
+
+	return -1;
+}
+
+/*
+ * get_contents() using the extent cache: every run of consecutive clusters
+ * is read with a single disk_read().
+ */
+static int get_contents_extents(fsdata *mydata, dir_entry *dentptr,
+				loff_t pos, __u8 *buffer, loff_t maxsize,
+				loff_t *gotsize)
+{
+	loff_t filesize = FAT2CPU32(dentptr->size);
+	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
+	__u32 needed = DIV_ROUND_UP(FAT2CPU32(dentptr->size), bytesperclust);
+	__u32 idx, offset, clust, run;
+	loff_t actsize;
+
+	*gotsize = 0;
+	debug("Filesize: %llu bytes\n", filesize);
+
+	if (pos >= filesize) {
+		debug("Read position past EOF: %llu\n", pos);
+		return 0;
+	}
+
+	if (maxsize > 0 && filesize > pos + maxsize)
+		filesize = pos + maxsize;
+
+	while (pos < filesize) {
+		/* FAT file sizes, and so pos, fit in 32 bits */
+		idx = (__u32)pos / bytesperclust;
+		offset = (__u32)pos % bytesperclust;
+		if (fat_extents_lookup(mydata, START(dentptr), needed, idx,
+				       &clust, &run))
+			return -1;
+
+		if (offset) {
+			/* Partial first cluster, read it through a buffer */
+			__u8 *tmp_buffer;
+
+			actsize = min(filesize - pos + offset,
+				      (loff_t)bytesperclust);
+			tmp_buffer = malloc_cache_aligned(actsize);
+			if (!tmp_buffer) {
+				debug("Error: allocating buffer\n");
+				return -1;
+			}
+
+			if (get_cluster(mydata, clust, tmp_buffer, actsize)) {
+				printf("Error reading cluster\n");
+				free(tmp_buffer);
+				return -1;
+			}
+			actsize -= offset;
+			memcpy(buffer, tmp_buffer + offset, actsize);
+			free(tmp_buffer);
+		} else {
+			actsize = min(filesize - pos,
+				      (loff_t)run * bytesperclust);
+			if (get_cluster(mydata, clust, buffer, actsize)) {
+				printf("Error reading cluster\n");
+				return -1;
+			}
+		}
+
+		*gotsize += actsize;
+		buffer += actsize;
+		pos += actsize;
+	}
+
+	return 0;
+}
+#else
+static inline void fat_extents_invalidate(void)
+{
+}
+
+static inline void fat_extents_check_volume(const __u8 volume_id[4])
+{
+}
+
+static inline int get_contents_extents(fsdata *mydata, dir_entry *dentptr,
+				       loff_t pos, __u8 *buffer,
+				       loff_t maxsize, loff_t *gotsize)
+{
+	return -1;
+}
+#endif /* CONFIG_FS_FAT_EXTENT_CACHE */
+
 /**
  * get_contents() - read from file
  *
@@ -328,6 +782,10 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 	__u32 endclust, newclust;
 	loff_t actsize;
 
+	if (IS_ENABLED(CONFIG_FS_FAT_EXTENT_CACHE))
+		return get_contents_extents(mydata, dentptr, pos, buffer,
+					    maxsize, gotsize);
+
 	*gotsize = 0;
 	debug("Filesize: %llu bytes\n", filesize);
 
@@ -565,6 +1023,8 @@ static int get_fs_info(fsdata *mydata)
 		debug("Error: reading boot sector\n");
 		return ret;
 	}
+	fat_extents_check_volume(volinfo.volume_id);
+	fat_table_check_volume(volinfo.volume_id);
 
 	if (mydata->fatsize == 32) {
 		mydata->fatlength = bs.fat32_length;
@@ -1160,6 +1620,7 @@ int file_fat_detectfs(void)
 	volinfo.fs_type[5] = '\0';
 
 	printf("Filesystem: %s \"%s\"\n", volinfo.fs_type, vol_label);
+	fat_table_print_stats();
 
 	return 0;
 }
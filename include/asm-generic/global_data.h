@@ -211,6 +211,26 @@ struct global_data {
 	 * @uclass_root_s.
 	 */
 	struct list_head *uclass_root;
+# if CONFIG_IS_ENABLED(DM_UCLASS_TABLE)
+	/**
+	 * @uclass_table: uclasses indexed by their ID, NULL where the
+	 * uclass does not exist or has not been looked up yet
+	 */
+	struct uclass **uclass_table;
+# endif
+# if CONFIG_IS_ENABLED(DM_COMPAT_INDEX)
+	/**
+	 * @dm_compat_index: hash table of driver compatible strings, built on
+	 * the first device tree bind, or an ERR_PTR() if that failed
+	 */
+	struct dm_compat_index *dm_compat_index;
+# endif
+# if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+	/**
+	 * @dm_ofnode_index: bound devices hashed by node and phandle
+	 */
+	struct dm_ofnode_index *dm_ofnode_index;
+# endif
 # if CONFIG_IS_ENABLED(OF_PLATDATA_DRIVER_RT)
 	/** @dm_driver_rt: Dynamic info about the driver */
 	struct driver_rt *dm_driver_rt;
@@ -494,6 +514,30 @@ static_assert(sizeof(struct global_data) == GD_SIZE);
 #define gd_dm_driver_rt()		NULL
 #endif
 
+#if CONFIG_IS_ENABLED(DM_UCLASS_TABLE)
+#define gd_set_uclass_table(tbl)	gd->uclass_table = tbl
+#define gd_uclass_table()		gd->uclass_table
+#else
+#define gd_set_uclass_table(tbl)
+#define gd_uclass_table()		NULL
+#endif
+
+#if CONFIG_IS_ENABLED(DM_COMPAT_INDEX)
+#define gd_set_dm_compat_index(idx)	gd->dm_compat_index = idx
+#define gd_dm_compat_index()		gd->dm_compat_index
+#else
+#define gd_set_dm_compat_index(idx)
+#define gd_dm_compat_index()		NULL
+#endif
+
+#if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+#define gd_set_dm_ofnode_index(idx)	gd->dm_ofnode_index = idx
+#define gd_dm_ofnode_index()		gd->dm_ofnode_index
+#else
+#define gd_set_dm_ofnode_index(idx)
+#define gd_dm_ofnode_index()		NULL
+#endif
+
 #if CONFIG_IS_ENABLED(OF_PLATDATA_RT)
 #define gd_set_dm_udevice_rt(dyn)	gd->dm_udevice_rt = dyn
 #define gd_dm_udevice_rt()		gd->dm_udevice_rt
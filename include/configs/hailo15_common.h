@@ -114,6 +114,22 @@
 /* see MSW-714 for details */
 #define UNNEEDED_MMCINFO_HACK "mmcinfo;"
 
+#ifdef CONFIG_TFTP_BLK_WRITE
+/* write the images to mmc while they are being downloaded */
+#define UPDATE_WIC_COMMAND "update_wic=" UNNEEDED_MMCINFO_HACK " tftpboot -w mmc ${device_num}:0 ${far_ram_addr} core-image-minimal-" CONFIG_SYS_BOARD ".wic\0"
+#define UPDATE_ROOTFS_COMMAND "update_rootfs=" UNNEEDED_MMCINFO_HACK " tftpboot -w mmc ${device_num}:${mmc_rootfs_partition} ${far_ram_addr} core-image-minimal-" CONFIG_SYS_BOARD ".ext4\0"
+#else
+#define UPDATE_WIC_COMMAND "update_wic=run download_wic_to_ram && run write_wic_to_mmc\0"
+#define UPDATE_ROOTFS_COMMAND "update_rootfs=run download_rootfs_to_ram && run write_rootfs_to_mmc\0"
+#endif
+
+#ifdef CONFIG_CMD_MMC_SWRITE
+/* erase the zeros in the image instead of writing them, takes sparse images too */
+#define MMC_IMAGE_WRITE "mmc swrite"
+#else
+#define MMC_IMAGE_WRITE "mmc write"
+#endif
+
 #define CONFIG_EXTRA_ENV_SETTINGS \
     "bootargs_base=console=ttyS1,115200n8 earlycon loglevel=8 rootwait debug rw\0" \
     "far_ram_addr=0x85000000\0" \
@@ -129,8 +145,8 @@
     "write_uboot_to_mmc0_mmc1=run set_mmc0_device_num && run write_uboot_to_mmc; run set_mmc1_device_num && run write_uboot_to_mmc\0" \
     /* "mmc write" writes in blocks, so we first calculate the number of blocks we read into wic_sdblock_count. */\
     /* we assume this is called after 'tftpboot' - so filesize is populated */\
-    "write_wic_to_mmc=setexpr wic_sdblock_count ${filesize} / ${sd_block_size} && setexpr wic_sdblock_count ${wic_sdblock_count} + 1; " UNNEEDED_MMCINFO_HACK " mmc write ${far_ram_addr} 0 ${wic_sdblock_count}\0" \
-    "write_rootfs_to_mmc=setexpr rootfs_sdblock_count ${filesize} / ${sd_block_size} && setexpr rootfs_sdblock_count ${rootfs_sdblock_count} + 1; " UNNEEDED_MMCINFO_HACK " run get_rootfs_partition_start_offset && mmc write ${far_ram_addr} ${rootfs_partition_start_offset} ${rootfs_sdblock_count}\0" \
+    "write_wic_to_mmc=setexpr wic_sdblock_count ${filesize} / ${sd_block_size} && setexpr wic_sdblock_count ${wic_sdblock_count} + 1; " UNNEEDED_MMCINFO_HACK " " MMC_IMAGE_WRITE " ${far_ram_addr} 0 ${wic_sdblock_count}\0" \
+    "write_rootfs_to_mmc=setexpr rootfs_sdblock_count ${filesize} / ${sd_block_size} && setexpr rootfs_sdblock_count ${rootfs_sdblock_count} + 1; " UNNEEDED_MMCINFO_HACK " run get_rootfs_partition_start_offset && " MMC_IMAGE_WRITE " ${far_ram_addr} ${rootfs_partition_start_offset} ${rootfs_sdblock_count}\0" \
     /* tftpboot sets filesize to the size it loaded */\
     "download_wic_to_ram=tftpboot ${far_ram_addr} core-image-minimal-" CONFIG_SYS_BOARD ".wic\0" \
     "download_rootfs_to_ram=tftpboot ${far_ram_addr} core-image-minimal-" CONFIG_SYS_BOARD ".ext4\0" \
@@ -139,10 +155,10 @@
     "boot_mmc=setenv bootargs ${bootargs_base} root=/dev/mmcblk${device_num}p${mmc_rootfs_partition}; run load_fitimage_from_mmc && bootm ${far_ram_addr}\0" \
     "boot_mmc0=run set_mmc0_device_num && run boot_mmc\0"\
     "boot_mmc1=run set_mmc1_device_num && run boot_mmc\0"\
-    "update_wic=run download_wic_to_ram && run write_wic_to_mmc\0" \
+    UPDATE_WIC_COMMAND \
     "update_wic_mmc0=run set_mmc0_device_num && run update_wic\0" \
     "update_wic_mmc1=run set_mmc1_device_num && run update_wic\0" \
-    "update_rootfs=run download_rootfs_to_ram && run write_rootfs_to_mmc\0" \
+    UPDATE_ROOTFS_COMMAND \
     "update_fitimage=run download_fitimage_to_ram && run write_fitimage_to_mmc\0" \
     "update_uboot=run download_uboot_to_ram && run write_uboot_to_mmc\0" \
     "update_uboot_mmc0_mmc1=run download_uboot_to_ram && run write_uboot_to_mmc0_mmc1\0" \
@@ -12,6 +12,9 @@
 
 #include <linker_lists.h>
 #include <dm/ofnode.h>
+#include <dm/uclass-id.h>
+#include <linux/errno.h>
+#include <linux/list.h>
 
 struct device_node;
 struct udevice;
@@ -163,6 +166,91 @@ int device_bind_by_name(struct udevice *parent, bool pre_reloc_only,
  */
 int device_reparent(struct udevice *dev, struct udevice *new_parent);
 
+#define DM_OFNODE_INDEX_BITS	7
+#define DM_OFNODE_INDEX_SIZE	(1 << DM_OFNODE_INDEX_BITS)
+
+/**
+ * struct dm_ofnode_index - Hash tables of bound devices with a node
+ *
+ * Devices are added when they are bound and removed when they are unbound.
+ * Each bucket lists its devices in the order they were bound, which is also
+ * their order within their uclass.
+ *
+ * @ofnode: Devices hashed by their node, linked by udevice->ofnode_node
+ * @phandle: Devices hashed by the phandle of their node, linked by
+ *	udevice->phandle_node. Devices whose node has no phandle are not here.
+ */
+struct dm_ofnode_index {
+	struct list_head ofnode[DM_OFNODE_INDEX_SIZE];
+	struct list_head phandle[DM_OFNODE_INDEX_SIZE];
+};
+
+#if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+/**
+ * device_index_init() - Set up an empty ofnode index
+ *
+ * This allocates the index if needed, or empties the existing one
+ *
+ * @return 0 if OK, -ENOMEM if out of memory
+ */
+int device_index_init(void);
+
+/**
+ * device_index_add() - Add a device to the ofnode index
+ *
+ * Nothing is done if there is no index or the device has no node
+ *
+ * @dev: Device to add
+ */
+void device_index_add(struct udevice *dev);
+
+/**
+ * device_index_remove() - Remove a device from the ofnode index
+ *
+ * @dev: Device to remove, which need not be in the index
+ */
+void device_index_remove(struct udevice *dev);
+
+/**
+ * device_index_find_ofnode() - Find devices with a node in the ofnode index
+ *
+ * @node: Node to look for, which must be valid
+ * @id: Uclass the device must be in, or UCLASS_INVALID for any uclass
+ * @devp: Returns the first matching device that was bound, or NULL if none
+ * @return number of matching devices, -ENOSYS if there is no index
+ */
+int device_index_find_ofnode(ofnode node, enum uclass_id id,
+			     struct udevice **devp);
+
+/**
+ * device_index_find_phandle() - Find a device by phandle in the ofnode index
+ *
+ * @phandle: Phandle of the device's node
+ * @id: Uclass the device must be in
+ * @devp: Returns the first matching device that was bound, or NULL if none
+ * @return 0 if found, -ENODEV if not found, -ENOSYS if there is no index or
+ * @phandle is 0
+ */
+int device_index_find_phandle(uint phandle, enum uclass_id id,
+			      struct udevice **devp);
+#else
+static inline int device_index_init(void) { return 0; }
+static inline void device_index_add(struct udevice *dev) {}
+static inline void device_index_remove(struct udevice *dev) {}
+
+static inline int device_index_find_ofnode(ofnode node, enum uclass_id id,
+					   struct udevice **devp)
+{
+	return -ENOSYS;
+}
+
+static inline int device_index_find_phandle(uint phandle, enum uclass_id id,
+					    struct udevice **devp)
+{
+	return -ENOSYS;
+}
+#endif
+
 /**
  * device_of_to_plat() - Read platform data for a device
  *
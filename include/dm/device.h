@@ -161,6 +161,11 @@ enum {
  *		automatically when the device is removed / unbound
  * @dma_offset: Offset between the physical address space (CPU's) and the
  *		device's bus address space
+ * @ofnode_node: Used by driver model to find the device by its node, in the
+ *		ofnode index (do not access outside driver model)
+ * @phandle_node: Used by driver model to find the device by the phandle of
+ *		its node, in the ofnode index (do not access outside driver
+ *		model)
  */
 struct udevice {
 	const struct driver *driver;
@@ -190,6 +195,10 @@ struct udevice {
 #if CONFIG_IS_ENABLED(DM_DMA)
 	ulong dma_offset;
 #endif
+#if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+	struct list_head ofnode_node;
+	struct list_head phandle_node;
+#endif
 };
 
 /**
@@ -279,9 +288,22 @@ static inline bool dev_has_ofnode(const struct udevice *dev)
 #endif
 }
 
+/**
+ * device_index_set_ofnode() - Set the node of a device in the ofnode index
+ *
+ * This updates the node and moves the device to its new place in the index,
+ * if it is in the index. Use dev_set_ofnode() instead.
+ *
+ * @dev: Device to update
+ * @node: New node for the device
+ */
+void device_index_set_ofnode(struct udevice *dev, ofnode node);
+
 static inline void dev_set_ofnode(struct udevice *dev, ofnode node)
 {
-#if CONFIG_IS_ENABLED(OF_REAL)
+#if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+	device_index_set_ofnode(dev, node);
+#elif CONFIG_IS_ENABLED(OF_REAL)
 	dev->node_ = node;
 #endif
 }
@@ -64,6 +64,10 @@ void gzwrite_progress_finish(int retcode, ulong totalwritten, ulong totalsize,
 /**
  * gzwrite() - decompress and write gzipped image from memory to block device
  *
+ * A zstd frame is accepted too if ZSTD is enabled. Its content size, if
+ * present in the frame header, takes the place of the gzip trailer. If
+ * neither @szexpected nor the frame gives a size, the size is not checked.
+ *
  * @src:	compressed image address
  * @len:	compressed image length in bytes
  * @dev:	block device descriptor
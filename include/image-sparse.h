@@ -24,6 +24,15 @@ struct sparse_storage {
 				 lbaint_t blk,
 				 lbaint_t blkcnt);
 
+	/*
+	 * Optional: erase whole groups of erase_grp blocks, which must read
+	 * back as zeros afterwards. Runs of zeros are written when unset.
+	 */
+	u32		erase_grp;
+	lbaint_t	(*erase)(struct sparse_storage *info,
+				 lbaint_t blk,
+				 lbaint_t blkcnt);
+
 	void		(*mssg)(const char *str, char *response);
 };
 
@@ -40,3 +49,19 @@ static inline int is_sparse_image(void *buf)
 
 int write_sparse_image(struct sparse_storage *info, const char *part_name,
 		       void *data, char *response);
+
+/**
+ * write_raw_image_sparse() - Write a raw image, erasing its runs of zeros
+ *
+ * Whole erase groups of zeros are passed to info->erase, everything else
+ * to info->write. Without info->erase this is a plain write.
+ *
+ * @info: Storage to write to
+ * @part_name: Name of the destination, for messages
+ * @data: Image in memory
+ * @blkcnt: Size of the image in info->blksz blocks
+ * @response: Passed on to info->mssg
+ * @return 0 if OK, -1 on error
+ */
+int write_raw_image_sparse(struct sparse_storage *info, const char *part_name,
+			   void *data, lbaint_t blkcnt, char *response);
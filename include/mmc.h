@@ -231,6 +231,7 @@ static inline bool mmc_is_tuning_cmd(uint cmdidx)
 #define EXT_CSD_ERASE_GROUP_DEF		175	/* R/W */
 #define EXT_CSD_BOOT_BUS_WIDTH		177
 #define EXT_CSD_PART_CONF		179	/* R/W */
+#define EXT_CSD_ERASED_MEM_CONT		181	/* RO */
 #define EXT_CSD_BUS_WIDTH		183	/* R/W */
 #define EXT_CSD_STROBE_SUPPORT		184	/* R/W */
 #define EXT_CSD_HS_TIMING		185	/* R/W */
@@ -815,6 +816,18 @@ int mmc_pwrseq_get_power(struct udevice *dev, struct mmc_config *cfg);
 
 int mmc_read(struct mmc *mmc, u64 src, uchar *dst, int size);
 
+/**
+ * mmc_erase_zero_grp() - Get the granularity of erases that leave zeros
+ *
+ * Erasing is much faster than writing zeros, but only whole erase groups
+ * can be erased, and only some devices read back zeros afterwards.
+ *
+ * @mmc:	MMC device
+ * @return erase group size in blocks if erased blocks read back as zeros,
+ *	0 if they do not or this is not known
+ */
+uint mmc_erase_zero_grp(struct mmc *mmc);
+
 /**
  * mmc_voltage_to_mv() - Convert a mmc_voltage in mV
  *
@@ -22,6 +22,28 @@ void tftp_start(enum proto_t protocol);	/* Begin TFTP get/put */
 void tftp_start_server(void);	/* Wait for incoming TFTP put */
 #endif
 
+#ifdef CONFIG_TFTP_BLK_WRITE
+#include <blk.h>
+
+/**
+ * tftp_set_blk_target() - Stream the next TFTP download to a block device
+ *
+ * While a target is set, received data is staged at the load address and
+ * written to @desc in CONFIG_TFTP_BLK_WRITE_BUF_SIZE chunks as the
+ * transfer progresses. A partial last block is padded with zeros.
+ *
+ * @desc:	Block device to write to, or NULL to load into memory again
+ * @start:	First block of the target area
+ * @count:	Number of blocks available in the target area
+ * @part:	True if the target area is a partition. A download that starts
+ *		with a partition table is then refused, since a whole-disk
+ *		image does not belong in a partition.
+ * @return 0 if OK, -EINVAL if the staging buffer does not suit @desc
+ */
+int tftp_set_blk_target(struct blk_desc *desc, lbaint_t start,
+			lbaint_t count, bool part);
+#endif
+
 extern ulong tftp_timeout_ms;
 extern int tftp_timeout_count_max;
 
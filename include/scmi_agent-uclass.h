@@ -19,6 +19,17 @@ struct scmi_agent_ops {
 	 * @msg:		SCMI message to be transmitted
 	 */
 	int (*process_msg)(struct udevice *dev, struct scmi_msg *msg);
+	/*
+	 * process_msgs - Request transport to get several independent SCMI
+	 * messages processed, as few server round trips as it can manage.
+	 * Optional, messages are otherwise sent one by one with process_msg.
+	 *
+	 * @agent:		Agent using the transport
+	 * @msgs:		SCMI messages to be transmitted
+	 * @count:		Number of messages in @msgs
+	 */
+	int (*process_msgs)(struct udevice *dev, struct scmi_msg *msgs,
+			    unsigned int count);
 };
 
 #endif /* _SCMI_TRANSPORT_UCLASS_H */
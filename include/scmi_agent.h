@@ -57,6 +57,24 @@ struct scmi_msg {
  */
 int devm_scmi_process_msg(struct udevice *dev, struct scmi_msg *msg);
 
+/**
+ * devm_scmi_process_msgs() - send and process several SCMI messages
+ *
+ * Send independent messages to a SCMI server through a target SCMI agent
+ * device, letting the transport group them into as few exchanges with the
+ * server as it can. The server may handle them in any order. Each message
+ * is handled as by devm_scmi_process_msg() and carries its own SCMI status
+ * in its response.
+ *
+ * @dev:	SCMI agent device
+ * @msgs:	Array of message structure references
+ * @count:	Number of messages in @msgs
+ * @return 0 on success and a negative errno if a message could not be
+ * exchanged with the server
+ */
+int devm_scmi_process_msgs(struct udevice *dev, struct scmi_msg *msgs,
+			   unsigned int count);
+
 /**
  * scmi_to_linux_errno() - Convert an SCMI error code into a Linux errno code
  *
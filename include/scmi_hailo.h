@@ -18,6 +18,11 @@
  * @return 0 for successful status and a negative errno otherwise
  */
 #if IS_ENABLED(CONFIG_SCMI_HAILO)
+int scmi_hailo_configure_ethernet(
+    struct udevice *dev, uint8_t tx_bypass_clock_delay, uint8_t tx_clock_inversion,
+    uint8_t tx_clock_delay, uint8_t rx_bypass_clock_delay,
+    uint8_t rx_clock_inversion, uint8_t rx_clock_delay, bool rmii);
+
 int scmi_hailo_configure_ethernet_delay(
     struct udevice *dev, uint8_t tx_bypass_clock_delay, uint8_t tx_clock_inversion,
     uint8_t tx_clock_delay, uint8_t rx_bypass_clock_delay,
@@ -28,6 +33,14 @@ int scmi_hailo_set_eth_rmii(struct udevice *dev);
 int scmi_hailo_get_boot_info(struct udevice *dev, struct scmi_hailo_get_boot_info_p2a *boot_info);
 
 #else
+static inline int scmi_hailo_configure_ethernet(
+    struct udevice *dev, uint8_t tx_bypass_clock_delay, uint8_t tx_clock_inversion,
+    uint8_t tx_clock_delay, uint8_t rx_bypass_clock_delay,
+    uint8_t rx_clock_inversion, uint8_t rx_clock_delay, bool rmii)
+{
+    return SCMI_NOT_SUPPORTED;
+}
+
 int scmi_hailo_configure_ethernet_delay(
     struct udevice *dev, uint8_t tx_bypass_clock_delay, uint8_t tx_clock_inversion,
     uint8_t tx_clock_delay, uint8_t rx_bypass_clock_delay,
@@ -74,6 +74,8 @@ struct scmi_base_discover_implementation_version_out {
  */
 
 enum scmi_clock_message_id {
+	SCMI_CLOCK_PROTOCOL_ATTRIBUTES = 0x1,
+	SCMI_CLOCK_DESCRIBE_RATES = 0x4,
 	SCMI_CLOCK_RATE_SET = 0x5,
 	SCMI_CLOCK_RATE_GET = 0x6,
 	SCMI_CLOCK_CONFIG_SET = 0x7,
@@ -85,6 +87,68 @@ enum scmi_clock_message_id {
 #define SCMI_CLK_RATE_ROUND_UP		BIT(2)
 #define SCMI_CLK_RATE_ROUND_CLOSEST	BIT(3)
 
+#define SCMI_CLK_PROTO_ATTRS_NUM_CLOCKS(x)	((x) & GENMASK(15, 0))
+
+#define SCMI_CLK_RATES_NUM(x)		((x) & GENMASK(11, 0))
+#define SCMI_CLK_RATES_RANGE		BIT(12)
+#define SCMI_CLK_RATES_REMAINING(x)	((x) >> 16)
+#define SCMI_CLK_RATES_MAX		32
+
+/**
+ * struct scmi_clk_protocol_attr_in - Message payload for
+ *	CLOCK PROTOCOL_ATTRIBUTES command
+ */
+struct scmi_clk_protocol_attr_in {
+};
+
+/**
+ * struct scmi_clk_protocol_attr_out - Response payload for
+ *	CLOCK PROTOCOL_ATTRIBUTES command
+ * @status:	SCMI command status
+ * @attributes:	Number of clocks in bits [15:0], max pending async requests
+ *		in bits [23:16]
+ */
+struct scmi_clk_protocol_attr_out {
+	s32 status;
+	u32 attributes;
+};
+
+/**
+ * struct scmi_clk_describe_rates_in - Message payload for
+ *	CLOCK_DESCRIBE_RATES command
+ * @clock_id:	SCMI clock ID
+ * @rate_index:	Index of the first rate to describe
+ */
+struct scmi_clk_describe_rates_in {
+	u32 clock_id;
+	u32 rate_index;
+};
+
+/**
+ * struct scmi_clk_rate - Clock rate as sent in CLOCK_DESCRIBE_RATES response
+ * @rate_lsb:	32bit LSB of the clock rate in Hertz
+ * @rate_msb:	32bit MSB of the clock rate in Hertz
+ */
+struct scmi_clk_rate {
+	u32 rate_lsb;
+	u32 rate_msb;
+};
+
+/**
+ * struct scmi_clk_describe_rates_out - Response payload for
+ *	CLOCK_DESCRIBE_RATES command
+ * @status:	SCMI command status
+ * @num_rates_flags: Number of rates returned in bits [11:0], range format
+ *		flag in bit 12, number of remaining rates in bits [31:16]
+ * @rate:	Discrete rates, or the lowest rate, highest rate and step of
+ *		a range
+ */
+struct scmi_clk_describe_rates_out {
+	s32 status;
+	u32 num_rates_flags;
+	struct scmi_clk_rate rate[SCMI_CLK_RATES_MAX];
+};
+
 /**
  * struct scmi_clk_state_in - Message payload for CLOCK_CONFIG_SET command
  * @clock_id:	SCMI clock ID
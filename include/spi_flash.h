@@ -103,6 +103,14 @@ int spi_flash_erase_dm(struct udevice *dev, u32 offset, size_t len);
  */
 int spl_flash_get_sw_write_prot(struct udevice *dev);
 
+/**
+ * spi_flash_cache_get_stats() - Get the counters of the SPI flash read cache
+ *
+ * @hits:	Returns the number of sectors read from the cache
+ * @misses:	Returns the number of sectors read into the cache
+ */
+void spi_flash_cache_get_stats(ulong *hits, ulong *misses);
+
 /**
  * spi_flash_std_probe() - Probe a SPI flash device
  *
@@ -120,4 +120,19 @@ void crc32c_init(uint32_t *crc32c_table, uint32_t pol);
 uint32_t crc32c_cal(uint32_t crc, const char *data, int length,
 		    uint32_t *crc32c_table);
 
+/**
+ * crc32c() - Calculate the CRC32C (Castagnoli) of a buffer
+ *
+ * Like the Linux function of the same name, this neither inverts @crc on
+ * entry nor the result; pass ~0 at start and invert the final value to get
+ * the standard checksum. Uses the CRC32C instructions when ARM64_CRC32 is
+ * enabled.
+ *
+ * @crc: Previous crc
+ * @data: Data bytes to checksum
+ * @length: Number of bytes to process
+ * @return checksum value
+ */
+uint32_t crc32c(uint32_t crc, const void *data, size_t length);
+
 #endif /* _UBOOT_CRC_H */
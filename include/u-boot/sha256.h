@@ -19,6 +19,21 @@ void sha256_starts(sha256_context * ctx);
 void sha256_update(sha256_context *ctx, const uint8_t *input, uint32_t length);
 void sha256_finish(sha256_context * ctx, uint8_t digest[SHA256_SUM_LEN]);
 
+/**
+ * sha256_process() - Run the SHA-256 compression function on whole blocks
+ *
+ * This is the hook used by sha256_update(). The generic version below is
+ * used unless an architecture provides an accelerated one.
+ *
+ * @ctx:	Context whose state is updated
+ * @data:	Input, @blocks * 64 bytes
+ * @blocks:	Number of 64-byte blocks to process
+ */
+void sha256_process(sha256_context *ctx, const uint8_t *data,
+		    unsigned int blocks);
+void sha256_process_generic(sha256_context *ctx, const uint8_t *data,
+			    unsigned int blocks);
+
 void sha256_csum_wd(const unsigned char *input, unsigned int ilen,
 		unsigned char *output, unsigned int chunk_sz);
 
@@ -31,6 +31,12 @@
 
 #define tole(x) cpu_to_le32(x)
 
+#if !defined(USE_HOSTCC) && __BYTE_ORDER == __LITTLE_ENDIAN
+#if CONFIG_IS_ENABLED(CRC32_SLICE_BY_8)
+#define CRC_SLICE_BY_8
+#endif
+#endif
+
 #ifdef CONFIG_DYNAMIC_CRC_TABLE
 
 static int __efi_runtime_data crc_table_empty = 1;
@@ -179,6 +185,59 @@ const uint32_t * ZEXPORT get_crc_table()
 
 /* ========================================================================= */
 
+#ifdef CRC_SLICE_BY_8
+/*
+  crc_slice[k][n] is the CRC of byte n followed by k zero bytes. Eight input
+  bytes are then folded into the CRC with eight independent table lookups,
+  instead of eight lookups that each depend on the previous one. The tables
+  are derived from crc_table on first use.
+*/
+static int __efi_runtime_data crc_slice_empty = 1;
+static uint32_t __efi_runtime_data crc_slice[8][256];
+
+static void __efi_runtime make_crc_slice(void)
+{
+  uint32_t c;
+  int n, k;
+
+#ifdef CONFIG_DYNAMIC_CRC_TABLE
+  if (crc_table_empty)
+    make_crc_table();
+#endif
+  for (n = 0; n < 256; n++)
+  {
+    c = crc_table[n];
+    crc_slice[0][n] = c;
+    for (k = 1; k < 8; k++)
+    {
+      c = crc_table[c & 255] ^ (c >> 8);
+      crc_slice[k][n] = c;
+    }
+  }
+  crc_slice_empty = 0;
+}
+
+static uint32_t __efi_runtime crc32_slice(uint32_t crc, const uint64_t *b,
+					  uInt count)
+{
+    uint32_t lo, hi;
+
+    if (crc_slice_empty)
+      make_crc_slice();
+
+    while (count--) {
+	 lo = crc ^ (uint32_t)*b;
+	 hi = (uint32_t)(*b++ >> 32);
+	 crc = crc_slice[7][lo & 255] ^ crc_slice[6][(lo >> 8) & 255] ^
+	       crc_slice[5][(lo >> 16) & 255] ^ crc_slice[4][lo >> 24] ^
+	       crc_slice[3][hi & 255] ^ crc_slice[2][(hi >> 8) & 255] ^
+	       crc_slice[1][(hi >> 16) & 255] ^ crc_slice[0][hi >> 24];
+    }
+
+    return crc;
+}
+#endif
+
 /* No ones complement version. JFFS2 (and other things ?)
  * don't use ones compliment in their CRC calculations.
  */
@@ -186,9 +245,34 @@ uint32_t __efi_runtime crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
 {
 #ifdef CONFIG_ARM64_CRC32
     crc = cpu_to_le32(crc);
+    /* Align for the 64-bit loads, which may run with the caches off */
+    while (len && ((uintptr_t)buf & 7)) {
+        crc = __builtin_aarch64_crc32b(crc, *buf++);
+        len--;
+    }
+    for (; len >= 8; len -= 8, buf += 8)
+        crc = __builtin_aarch64_crc32x(crc, *(const uint64_t *)buf);
     while (len--)
         crc = __builtin_aarch64_crc32b(crc, *buf++);
     return le32_to_cpu(crc);
+#elif defined(CRC_SLICE_BY_8)
+    const uint32_t *tab = crc_table;
+
+#ifdef CONFIG_DYNAMIC_CRC_TABLE
+    if (crc_table_empty)
+      make_crc_table();
+#endif
+    while (len && ((uintptr_t)buf & 7)) {
+	 DO_CRC(*buf++);
+	 len--;
+    }
+    crc = crc32_slice(crc, (const uint64_t *)buf, len >> 3);
+    buf += len & ~7;
+    len &= 7;
+    while (len--)
+	 DO_CRC(*buf++);
+
+    return crc;
 #else
     const uint32_t *tab = crc_table;
     const uint32_t *b =(const uint32_t *)buf;
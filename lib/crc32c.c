@@ -36,3 +36,35 @@ void crc32c_init(uint32_t *crc32c_table, uint32_t pol)
 		crc32c_table[i] = v;
 	}
 }
+
+#ifdef CONFIG_ARM64_CRC32
+uint32_t crc32c(uint32_t crc, const void *data, size_t length)
+{
+	const u8 *p = data;
+
+	/* Align for the 64-bit loads, which may run with the caches off */
+	while (length && ((uintptr_t)p & 7)) {
+		crc = __builtin_aarch64_crc32cb(crc, *p++);
+		length--;
+	}
+	for (; length >= 8; length -= 8, p += 8)
+		crc = __builtin_aarch64_crc32cx(crc, *(const u64 *)p);
+	while (length--)
+		crc = __builtin_aarch64_crc32cb(crc, *p++);
+
+	return crc;
+}
+#else
+static uint32_t crc32c_table[256];
+static bool crc32c_table_ready;
+
+uint32_t crc32c(uint32_t crc, const void *data, size_t length)
+{
+	if (!crc32c_table_ready) {
+		crc32c_init(crc32c_table, 0x82F63B78);
+		crc32c_table_ready = true;
+	}
+
+	return crc32c_cal(crc, data, length, crc32c_table);
+}
+#endif
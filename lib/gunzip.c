@@ -13,9 +13,12 @@
 #include <image.h>
 #include <malloc.h>
 #include <memalign.h>
+#include <mmc.h>
 #include <u-boot/crc.h>
 #include <watchdog.h>
+#include <asm/unaligned.h>
 #include <u-boot/zlib.h>
+#include <linux/zstd.h>
 
 #define HEADER0			'\x1f'
 #define HEADER1			'\x8b'
@@ -116,6 +119,164 @@ void gzwrite_progress_finish(int returnval,
 	}
 }
 
+#ifdef CONFIG_GZWRITE_ERASE_ZEROS
+/* Return the erase group size of @dev if erasing leaves zeros, else 0 */
+static uint gzwrite_erase_grp(struct blk_desc *dev)
+{
+	struct mmc *mmc;
+
+	if (dev->if_type != IF_TYPE_MMC)
+		return 0;
+	mmc = find_mmc_device(dev->devnum);
+
+	return mmc ? mmc_erase_zero_grp(mmc) : 0;
+}
+
+static bool gzwrite_is_zero(const void *buf, ulong len)
+{
+	const ulong *p = buf;
+
+	for (; len; len -= sizeof(*p))
+		if (*p++)
+			return false;
+
+	return true;
+}
+#endif
+
+/*
+ * Write @blkcnt blocks from @buf at @start and return the number of blocks
+ * written. A buffer of zeros that covers whole erase groups is erased
+ * instead, if the device leaves zeros behind.
+ */
+static ulong gzwrite_blocks(struct blk_desc *dev, lbaint_t start,
+			    lbaint_t blkcnt, const void *buf)
+{
+#ifdef CONFIG_GZWRITE_ERASE_ZEROS
+	u64 pos = start;
+	uint grp;
+
+	if (gzwrite_is_zero(buf, blkcnt * dev->blksz)) {
+		grp = gzwrite_erase_grp(dev);
+		if (grp && !do_div(pos, grp) && !((ulong)blkcnt % grp) &&
+		    blk_derase(dev, start, blkcnt) == blkcnt)
+			return blkcnt;
+	}
+#endif
+
+	return blk_dwrite(dev, start, blkcnt, buf);
+}
+
+#if CONFIG_IS_ENABLED(ZSTD)
+#define ZSTD_MAGIC		0xfd2fb528
+
+static int zstdwrite(unsigned char *src, int len, struct blk_desc *dev,
+		     ulong szwritebuf, lbaint_t outblock, ulong szexpected)
+{
+	ZSTD_frameParams params;
+	ZSTD_DStream *dstream;
+	ZSTD_inBuffer in_buf;
+	ZSTD_outBuffer out_buf;
+	unsigned char *writebuf;
+	void *workspace;
+	ulong totalfilled = 0;
+	lbaint_t writeblocks;
+	size_t wsize, in_pos, out_pos, res;
+	int iteration = 0;
+	int r = -1;
+
+	if (ZSTD_getFrameParams(&params, src, len) || !params.windowSize) {
+		puts("Error: Bad zstd data\n");
+		return -1;
+	}
+	/* Without a size given or in the frame, the size is not checked */
+	if (!szexpected)
+		szexpected = params.frameContentSize;
+	if (lldiv(szexpected, dev->blksz) > (dev->lba - outblock)) {
+		printf("%s: uncompressed size %lu exceeds device size\n",
+		       __func__, szexpected);
+		return -1;
+	}
+
+	gzwrite_progress_init(szexpected);
+
+	wsize = ZSTD_DStreamWorkspaceBound(params.windowSize);
+	workspace = malloc(wsize);
+	writebuf = malloc_cache_aligned(szwritebuf);
+	if (!workspace || !writebuf) {
+		printf("%s: cannot allocate buffers\n", __func__);
+		goto out;
+	}
+
+	dstream = ZSTD_initDStream(params.windowSize, workspace, wsize);
+	if (!dstream) {
+		printf("Error: ZSTD_initDStream() failed\n");
+		goto out;
+	}
+
+	in_buf.src = src;
+	in_buf.pos = 0;
+	in_buf.size = len;
+	out_buf.dst = writebuf;
+	out_buf.size = szwritebuf;
+
+	/* decompress until the frame ends, writing each full buffer */
+	do {
+		out_buf.pos = 0;
+		do {
+			in_pos = in_buf.pos;
+			out_pos = out_buf.pos;
+			res = ZSTD_decompressStream(dstream, &out_buf, &in_buf);
+			if (ZSTD_isError(res)) {
+				printf("Error: ZSTD_decompressStream() returned %d\n",
+				       ZSTD_getErrorCode(res));
+				goto out;
+			}
+			if (in_buf.pos == in_pos && out_buf.pos == out_pos) {
+				puts("Error: zstd data is truncated\n");
+				goto out;
+			}
+		} while (res && out_buf.pos < out_buf.size);
+
+		totalfilled += out_buf.pos;
+		writeblocks = DIV_ROUND_UP(out_buf.pos, dev->blksz);
+		if (writeblocks > dev->lba - outblock) {
+			printf("%s: uncompressed data exceeds device size\n",
+			       __func__);
+			goto out;
+		}
+		memset(writebuf + out_buf.pos, 0,
+		       writeblocks * dev->blksz - out_buf.pos);
+
+		gzwrite_progress(iteration++, totalfilled, szexpected);
+		if (gzwrite_blocks(dev, outblock, writeblocks,
+				   writebuf) != writeblocks) {
+			printf("%s: write failed at block " LBAF "\n",
+			       __func__, outblock);
+			goto out;
+		}
+		outblock += writeblocks;
+		if (ctrlc()) {
+			puts("abort\n");
+			goto out;
+		}
+		WATCHDOG_RESET();
+	} while (res);
+
+	/* zstd checks its own content checksum, if the frame has one */
+	if (!szexpected)
+		szexpected = totalfilled;
+	r = szexpected == totalfilled ? 0 : -1;
+
+out:
+	gzwrite_progress_finish(r, totalfilled, szexpected, 0, 0);
+	free(writebuf);
+	free(workspace);
+
+	return r;
+}
+#endif
+
 int gzwrite(unsigned char *src, int len,
 	    struct blk_desc *dev,
 	    unsigned long szwritebuf,
@@ -150,6 +311,12 @@ int gzwrite(unsigned char *src, int len,
 	blksperbuf = szwritebuf / dev->blksz;
 	outblock = lldiv(startoffs, dev->blksz);
 
+#if CONFIG_IS_ENABLED(ZSTD)
+	if (len >= 4 && get_unaligned_le32(src) == ZSTD_MAGIC)
+		return zstdwrite(src, len, dev, szwritebuf, outblock,
+				 szexpected);
+#endif
+
 	/* skip header */
 	i = 10;
 	flags = src[3];
@@ -244,8 +411,14 @@ int gzwrite(unsigned char *src, int len,
 			gzwrite_progress(iteration++,
 					 totalfilled,
 					 szexpected);
-			blocks_written = blk_dwrite(dev, outblock,
-						    writeblocks, writebuf);
+			blocks_written = gzwrite_blocks(dev, outblock,
+							writeblocks, writebuf);
+			if (blocks_written != writeblocks) {
+				printf("%s: write failed at block " LBAF "\n",
+				       __func__, outblock);
+				r = -1;
+				goto out;
+			}
 			outblock += blocks_written;
 			if (ctrlc()) {
 				puts("abort\n");
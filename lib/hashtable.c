@@ -33,6 +33,7 @@
 # include <common.h>
 # include <linux/string.h>
 # include <linux/ctype.h>
+# include <linux/log2.h>
 #endif
 
 #ifndef	CONFIG_ENV_MIN_ENTRIES	/* minimum number of entries */
@@ -45,6 +46,10 @@
 #define USED_FREE 0
 #define USED_DELETED -1
 
+#if defined(CONFIG_ENV_HASHTABLE_LINEAR) && !defined(USE_HOSTCC)
+#define HTAB_LINEAR
+#endif
+
 #include <env_callback.h>
 #include <env_flags.h>
 #include <search.h>
@@ -74,6 +79,105 @@ static void _hdelete(const char *key, struct hsearch_data *htab,
  * hcreate()
  */
 
+#ifdef HTAB_LINEAR
+/*
+ * Linear probing over a power-of-two table, which keeps the probes for a
+ * key in neighbouring nodes. The "used" field of a node holds 31 bits of
+ * the hash of its key, so a probe only compares the strings when those
+ * match. The nodes are followed by an index of the used slots sorted by
+ * key, kept up to date on insert and delete, so hexport_r() needs no sort.
+ */
+static unsigned int htab_hash(const char *key)
+{
+	unsigned int hval = 2166136261U;	/* FNV-1a */
+
+	while (*key) {
+		hval ^= (unsigned char)*key++;
+		hval *= 16777619U;
+	}
+	hval &= 0x7fffffff;
+
+	return hval ? hval : 1;
+}
+
+static unsigned int *htab_index(struct hsearch_data *htab)
+{
+	return (unsigned int *)(htab->table + htab->size + 1);
+}
+
+/* Return the position of @key in the sorted index, or where it would go */
+static unsigned int htab_index_find(struct hsearch_data *htab,
+				    const char *key)
+{
+	unsigned int *index = htab_index(htab);
+	unsigned int lo = 0, hi = htab->filled, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (strcmp(htab->table[index[mid]].entry.key, key) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+static void htab_index_insert(struct hsearch_data *htab, unsigned int idx)
+{
+	unsigned int *index = htab_index(htab);
+	unsigned int pos = htab_index_find(htab, htab->table[idx].entry.key);
+
+	memmove(index + pos + 1, index + pos,
+		(htab->filled - pos) * sizeof(*index));
+	index[pos] = idx;
+}
+
+static void htab_index_remove(struct hsearch_data *htab, unsigned int idx)
+{
+	unsigned int *index = htab_index(htab);
+	unsigned int pos = htab_index_find(htab, htab->table[idx].entry.key);
+
+	memmove(index + pos, index + pos + 1,
+		(htab->filled - pos - 1) * sizeof(*index));
+}
+
+/* At most three quarters of the nodes are used, to keep probes short */
+static unsigned int htab_max_filled(struct hsearch_data *htab)
+{
+	return htab->size - htab->size / 4;
+}
+
+int hcreate_r(size_t nel, struct hsearch_data *htab)
+{
+	/* Test for correct arguments.  */
+	if (htab == NULL) {
+		__set_errno(EINVAL);
+		return 0;
+	}
+
+	/* There is still another table active. Return with error. */
+	if (htab->table != NULL) {
+		__set_errno(EINVAL);
+		return 0;
+	}
+
+	htab->size = roundup_pow_of_two(nel + nel / 3 + 1);
+	htab->filled = 0;
+
+	/* allocate the nodes, starting from index 1, and the sorted index */
+	htab->table = calloc(1, (htab->size + 1) *
+			     sizeof(struct env_entry_node) +
+			     htab->size * sizeof(unsigned int));
+	if (htab->table == NULL) {
+		__set_errno(ENOMEM);
+		return 0;
+	}
+
+	/* everything went alright */
+	return 1;
+}
+#else
 /*
  * For the used double hash method the table size has to be a prime. To
  * correct the user given table size we need a prime test.  This trivial
@@ -134,7 +238,7 @@ int hcreate_r(size_t nel, struct hsearch_data *htab)
 	/* everything went alright */
 	return 1;
 }
-
+#endif /* HTAB_LINEAR */
 
 /*
  * hdestroy()
@@ -288,6 +392,99 @@ static inline int _compare_and_overwrite_entry(struct env_entry item,
 	return -1;
 }
 
+#ifdef HTAB_LINEAR
+int hsearch_r(struct env_entry item, enum env_action action,
+	      struct env_entry **retval, struct hsearch_data *htab, int flag)
+{
+	unsigned int hval = htab_hash(item.key);
+	unsigned int mask = htab->size - 1;
+	unsigned int first_deleted = 0;
+	unsigned int count, idx;
+	int ret;
+
+	/* Nodes are numbered from 1, node 0 is never used */
+	idx = (hval & mask) + 1;
+	for (count = 0; count < htab->size; count++) {
+		if (htab->table[idx].used == USED_FREE)
+			break;
+
+		if (htab->table[idx].used == USED_DELETED) {
+			if (!first_deleted)
+				first_deleted = idx;
+		} else {
+			ret = _compare_and_overwrite_entry(item, action, retval,
+				htab, flag, hval, idx);
+			if (ret != -1)
+				return ret;
+		}
+		idx = (idx & mask) + 1;
+	}
+
+	if (action != ENV_ENTER) {
+		__set_errno(ESRCH);
+		*retval = NULL;
+		return 0;
+	}
+
+	/* Reuse the first deleted node on the probe sequence, if any */
+	if (first_deleted)
+		idx = first_deleted;
+	else if (count == htab->size)
+		idx = 0;
+	if (!idx || htab->filled >= htab_max_filled(htab)) {
+		__set_errno(ENOMEM);
+		*retval = NULL;
+		return 0;
+	}
+
+	/* Create new entry; create copies of item.key and item.data */
+	htab->table[idx].entry.key = strdup(item.key);
+	htab->table[idx].entry.data = strdup(item.data);
+	if (!htab->table[idx].entry.key || !htab->table[idx].entry.data) {
+		free((void *)htab->table[idx].entry.key);
+		free(htab->table[idx].entry.data);
+		htab->table[idx].entry.key = NULL;
+		htab->table[idx].entry.data = NULL;
+		__set_errno(ENOMEM);
+		*retval = NULL;
+		return 0;
+	}
+	htab->table[idx].used = hval;
+	htab_index_insert(htab, idx);
+	++htab->filled;
+
+	/* This is a new entry, so look up a possible callback */
+	env_callback_init(&htab->table[idx].entry);
+	/* Also look for flags */
+	env_flags_init(&htab->table[idx].entry);
+
+	/* check for permission */
+	if (htab->change_ok != NULL && htab->change_ok(
+	    &htab->table[idx].entry, item.data, env_op_create, flag)) {
+		debug("change_ok() rejected setting variable "
+			"%s, skipping it!\n", item.key);
+		_hdelete(item.key, htab, &htab->table[idx].entry, idx);
+		__set_errno(EPERM);
+		*retval = NULL;
+		return 0;
+	}
+
+	/* If there is a callback, call it */
+	if (do_callback(&htab->table[idx].entry, item.key, item.data,
+			env_op_create, flag)) {
+		debug("callback() rejected setting variable "
+			"%s, skipping it!\n", item.key);
+		_hdelete(item.key, htab, &htab->table[idx].entry, idx);
+		__set_errno(EINVAL);
+		*retval = NULL;
+		return 0;
+	}
+
+	/* return new entry */
+	*retval = &htab->table[idx].entry;
+	return 1;
+}
+#else
 int hsearch_r(struct env_entry item, enum env_action action,
 	      struct env_entry **retval, struct hsearch_data *htab, int flag)
 {
@@ -435,7 +632,7 @@ int hsearch_r(struct env_entry item, enum env_action action,
 	*retval = NULL;
 	return 0;
 }
-
+#endif /* HTAB_LINEAR */
 
 /*
  * hdelete()
@@ -452,12 +649,28 @@ static void _hdelete(const char *key, struct hsearch_data *htab,
 {
 	/* free used entry */
 	debug("hdelete: DELETING key \"%s\"\n", key);
+#ifdef HTAB_LINEAR
+	htab_index_remove(htab, idx);
+#endif
 	free((void *)ep->key);
 	free(ep->data);
 	ep->flags = 0;
 	htab->table[idx].used = USED_DELETED;
 
 	--htab->filled;
+
+#ifdef HTAB_LINEAR
+	/*
+	 * Deleted nodes only keep probe sequences going; a run of them that
+	 * ends in a free node can become free again.
+	 */
+	if (htab->table[(idx & (htab->size - 1)) + 1].used == USED_FREE) {
+		while (htab->table[idx].used == USED_DELETED) {
+			htab->table[idx].used = USED_FREE;
+			idx = idx == 1 ? htab->size : idx - 1;
+		}
+	}
+#endif
 }
 
 int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
@@ -541,6 +754,18 @@ int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
  *		bytes in the string will be '\0'-padded.
  */
 
+#ifdef HTAB_LINEAR
+/* Return the node of the i-th entry in key order, or node 0 (unused) */
+static int export_idx(struct hsearch_data *htab, int i)
+{
+	return i <= htab->filled ? htab_index(htab)[i - 1] : 0;
+}
+#else
+static int export_idx(struct hsearch_data *htab, int i)
+{
+	return i;
+}
+
 static int cmpkey(const void *p1, const void *p2)
 {
 	struct env_entry *e1 = *(struct env_entry **)p1;
@@ -548,6 +773,7 @@ static int cmpkey(const void *p1, const void *p2)
 
 	return (strcmp(e1->key, e2->key));
 }
+#endif
 
 static int match_string(int flag, const char *str, const char *pat, void *priv)
 {
@@ -630,9 +856,10 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 	 * save addresses and compute total length
 	 */
 	for (i = 1, n = 0, totlen = 0; i <= htab->size; ++i) {
+		int idx = export_idx(htab, i);
 
-		if (htab->table[i].used > 0) {
-			struct env_entry *ep = &htab->table[i].entry;
+		if (htab->table[idx].used > 0) {
+			struct env_entry *ep = &htab->table[idx].entry;
 			int found = match_entry(ep, flag, argc, argv);
 
 			if ((argc > 0) && (found == 0))
@@ -671,8 +898,10 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 	}
 #endif
 
+#ifndef HTAB_LINEAR
 	/* Sort list by keys */
 	qsort(list, n, sizeof(struct env_entry *), cmpkey);
+#endif
 
 	/* Check if the user supplied buffer size is sufficient */
 	if (size) {
@@ -49,6 +49,75 @@
 
 static void default_log(const char *ignored, char *response) {}
 
+/* Write @blkcnt blocks at *@blk from a fill buffer of @fill_buf_num_blks */
+static int sparse_write_fill(struct sparse_storage *info, lbaint_t *blk,
+			     lbaint_t blkcnt, uint32_t *fill_buf,
+			     int fill_buf_num_blks, char *response)
+{
+	lbaint_t blks;
+	lbaint_t i;
+	int j;
+
+	for (i = 0; i < blkcnt;) {
+		j = blkcnt - i;
+		if (j > fill_buf_num_blks)
+			j = fill_buf_num_blks;
+		blks = info->write(info, *blk, j, fill_buf);
+		/* blks might be > j (eg. NAND bad-blocks) */
+		if (blks < j) {
+			printf("%s: %s " LBAFU " [%d]\n", __func__,
+			       "Write failed, block #", *blk, j);
+			info->mssg("flash write failure", response);
+			return -1;
+		}
+		*blk += blks;
+		i += j;
+	}
+
+	return 0;
+}
+
+/*
+ * Erase the whole erase groups among the @blkcnt blocks at @blk. Return the
+ * number of blocks erased from *@first on, or 0 if the range still has to be
+ * written.
+ */
+static lbaint_t sparse_erase(struct sparse_storage *info, lbaint_t blk,
+			     lbaint_t blkcnt, lbaint_t *first)
+{
+	u32 grp = info->erase_grp;
+	lbaint_t end;
+	u32 rem;
+
+	if (!info->erase || !grp)
+		return 0;
+
+	div_u64_rem(blk, grp, &rem);
+	*first = rem ? blk + grp - rem : blk;
+	div_u64_rem(blk + blkcnt, grp, &rem);
+	end = blk + blkcnt - rem;
+	if (end <= *first)
+		return 0;
+
+	if (info->erase(info, *first, end - *first) != end - *first)
+		return 0;
+
+	return end - *first;
+}
+
+static bool sparse_is_zero(struct sparse_storage *info, const void *data,
+			   lbaint_t blkcnt)
+{
+	const ulong *p = data;
+	u64 len = (u64)blkcnt * info->blksz;
+
+	for (; len; len -= sizeof(*p))
+		if (*p++)
+			return false;
+
+	return true;
+}
+
 int write_sparse_image(struct sparse_storage *info,
 		       const char *part_name, void *data, char *response)
 {
@@ -65,8 +134,9 @@ int write_sparse_image(struct sparse_storage *info,
 	chunk_header_t *chunk_header;
 	uint32_t total_blocks = 0;
 	int fill_buf_num_blks;
+	lbaint_t first, erased, tail;
+	int ret;
 	int i;
-	int j;
 
 	fill_buf_num_blks = CONFIG_IMAGE_SPARSE_FILLBUF_SIZE / info->blksz;
 
@@ -203,24 +273,30 @@ int write_sparse_image(struct sparse_storage *info,
 				return -1;
 			}
 
-			for (i = 0; i < blkcnt;) {
-				j = blkcnt - i;
-				if (j > fill_buf_num_blks)
-					j = fill_buf_num_blks;
-				blks = info->write(info, blk, j, fill_buf);
-				/* blks might be > j (eg. NAND bad-blocks) */
-				if (blks < j) {
-					printf("%s: %s " LBAFU " [%d]\n",
-					       __func__,
-					       "Write failed, block #",
-					       blk, j);
-					info->mssg("flash write failure",
-						   response);
-					free(fill_buf);
-					return -1;
-				}
-				blk += blks;
-				i += j;
+			/* A fill of zeros can be erased, apart from its ends */
+			erased = 0;
+			if (!fill_val)
+				erased = sparse_erase(info, blk, blkcnt, &first);
+			if (erased) {
+				tail = blk + blkcnt - first - erased;
+				ret = sparse_write_fill(info, &blk, first - blk,
+							fill_buf, fill_buf_num_blks,
+							response);
+				blk += erased;
+				if (!ret)
+					ret = sparse_write_fill(info, &blk, tail,
+								fill_buf,
+								fill_buf_num_blks,
+								response);
+			} else {
+				ret = sparse_write_fill(info, &blk, blkcnt,
+							fill_buf,
+							fill_buf_num_blks,
+							response);
+			}
+			if (ret) {
+				free(fill_buf);
+				return -1;
 			}
 			bytes_written += ((u64)blkcnt) * info->blksz;
 			total_blocks += DIV_ROUND_UP_ULL(chunk_data_sz,
@@ -263,3 +339,85 @@ int write_sparse_image(struct sparse_storage *info,
 
 	return 0;
 }
+
+static void *raw_data(struct sparse_storage *info, void *data, lbaint_t blk)
+{
+	return data + (blk - info->start) * info->blksz;
+}
+
+int write_raw_image_sparse(struct sparse_storage *info, const char *part_name,
+			   void *data, lbaint_t blkcnt, char *response)
+{
+	u32 grp = info->erase ? info->erase_grp : 0;
+	lbaint_t end = info->start + blkcnt;
+	lbaint_t blk, zero, next, blks;
+	uint64_t bytes_erased = 0;
+	u32 rem;
+
+	if (!info->mssg)
+		info->mssg = default_log;
+
+	if (blkcnt > info->size) {
+		printf("%s: Request would exceed partition size!\n", __func__);
+		info->mssg("Request would exceed partition size!", response);
+		return -1;
+	}
+
+	puts("Flashing Raw Image\n");
+
+	for (blk = info->start; blk < end; blk = next) {
+		/* Find the next erase group of zeros... */
+		zero = end;
+		if (grp) {
+			div_u64_rem(blk, grp, &rem);
+			for (zero = rem ? blk + grp - rem : blk;
+			     zero + grp <= end; zero += grp)
+				if (sparse_is_zero(info, raw_data(info, data, zero), grp))
+					break;
+			if (zero + grp > end)
+				zero = end;
+		}
+
+		/* ...and the end of the run of zeros it starts */
+		next = zero;
+		if (zero < end) {
+			do {
+				next += grp;
+			} while (next + grp <= end &&
+				 sparse_is_zero(info, raw_data(info, data, next), grp));
+		}
+
+		if (zero > blk) {
+			blks = info->write(info, blk, zero - blk,
+					   raw_data(info, data, blk));
+			if (blks < zero - blk) {
+				printf("%s: %s" LBAFU " [" LBAFU "]\n",
+				       __func__, "Write failed, block #",
+				       blk, blks);
+				info->mssg("flash write failure", response);
+				return -1;
+			}
+		}
+
+		if (next == zero)
+			continue;
+		if (info->erase(info, zero, next - zero) == next - zero) {
+			bytes_erased += (u64)(next - zero) * info->blksz;
+			continue;
+		}
+
+		/* The erase failed, write the zeros instead */
+		blks = info->write(info, zero, next - zero, raw_data(info, data, zero));
+		if (blks < next - zero) {
+			printf("%s: %s" LBAFU " [" LBAFU "]\n", __func__,
+			       "Write failed, block #", zero, blks);
+			info->mssg("flash write failure", response);
+			return -1;
+		}
+	}
+
+	printf("........ wrote %llu bytes (%llu erased) to '%s'\n",
+	       (u64)blkcnt * info->blksz, bytes_erased, part_name);
+
+	return 0;
+}
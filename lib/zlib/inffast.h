@@ -9,3 +9,12 @@
  */
 
 void inflate_fast OF((z_streamp strm, unsigned start));
+
+/* Input and output inflate() must have available to call inflate_fast() */
+#if CONFIG_IS_ENABLED(ZLIB_INFLATE_FAST_WIDE)
+#define INFLATE_FAST_MIN_IN 8           /* one 64-bit refill */
+#define INFLATE_FAST_MIN_OUT (258 + 15) /* longest match, chunk overrun */
+#else
+#define INFLATE_FAST_MIN_IN 6
+#define INFLATE_FAST_MIN_OUT 258
+#endif
@@ -0,0 +1,268 @@
+/* inffast_wide.c -- fast decoding with 64-bit loads and wide copies
+ * Copyright (C) 1995-2004 Mark Adler
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/* U-Boot: we already included these
+#include "zutil.h"
+#include "inftrees.h"
+#include "inflate.h"
+#include "inffast.h"
+*/
+
+/*
+   This is inflate_fast() from inffast.c reworked for 64-bit little-endian
+   CPUs that handle unaligned accesses well (AArch64 once the MMU is on):
+
+    - The bit buffer is refilled by one unaligned 64-bit load per code,
+      leaving at least 48 bits in it.  That is enough for a complete
+      length/distance pair (see inffast.c), so the decoder never has to
+      stop for more input in the middle of one.
+
+    - Matches are copied in 16-byte chunks, or 8-byte chunks for distances
+      below 16.  Distances below 8 are first widened to a multiple of the
+      distance that is at least 8, which repeats the same pattern.
+
+    - A chunk may write up to 15 bytes beyond the end of a match.  The
+      next literal or match overwrites them, and inflate() only calls this
+      with INFLATE_FAST_MIN_OUT bytes of output space, so nothing outside
+      the output buffer is touched.
+
+   Bits above "bits" in "hold" are not cleared by the refill, but they
+   always hold the matching bits of the next input bytes, so OR-ing in the
+   same bytes again on the next refill does not change them.  They are
+   masked off on return.
+
+   Entry assumptions are those of inffast.c, with strm->avail_in >=
+   INFLATE_FAST_MIN_IN and strm->avail_out >= INFLATE_FAST_MIN_OUT.
+ */
+
+static inline unsigned long inflate_load64(const unsigned char FAR *p)
+{
+    unsigned long v;
+
+    __builtin_memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/* copy len bytes from dist bytes back, in whole chunks; return the new out */
+static inline unsigned char FAR *inflate_chunk_copy(unsigned char FAR *out,
+                                                    unsigned dist,
+                                                    unsigned len)
+{
+    unsigned char FAR *from = out - dist;
+    unsigned char FAR *end = out + len;
+    unsigned n;
+
+    if (dist >= 16) {
+        do {
+            __builtin_memcpy(out, from, 16);
+            out += 16;
+            from += 16;
+        } while (out < end);
+        return end;
+    }
+    if (dist < 8) {
+        /* lay down the first eight bytes of the repeated pattern */
+        n = len < 8 ? len : 8;
+        do {
+            *out++ = *from++;
+        } while (--n);
+        if (out >= end)
+            return end;
+        dist *= (8 + dist - 1) / dist;
+        from = out - dist;
+    }
+    do {
+        __builtin_memcpy(out, from, 8);
+        out += 8;
+        from += 8;
+    } while (out < end);
+    return end;
+}
+
+void inflate_fast(z_streamp strm, unsigned start)
+/* start: inflate()'s starting value for strm->avail_out */
+{
+    struct inflate_state FAR *state;
+    unsigned char FAR *in;      /* local strm->next_in */
+    unsigned char FAR *last;    /* while in < last, enough input available */
+    unsigned char FAR *out;     /* local strm->next_out */
+    unsigned char FAR *beg;     /* inflate()'s initial strm->next_out */
+    unsigned char FAR *end;     /* while out < end, enough space available */
+#ifdef INFLATE_STRICT
+    unsigned dmax;              /* maximum distance from zlib header */
+#endif
+    unsigned wsize;             /* window size or zero if not using window */
+    unsigned whave;             /* valid bytes in the window */
+    unsigned write;             /* window write index */
+    unsigned char FAR *window;  /* allocated sliding window, if wsize != 0 */
+    unsigned long hold;         /* local strm->hold */
+    unsigned bits;              /* local strm->bits */
+    code const FAR *lcode;      /* local strm->lencode */
+    code const FAR *dcode;      /* local strm->distcode */
+    unsigned lmask;             /* mask for first level of length codes */
+    unsigned dmask;             /* mask for first level of distance codes */
+    code this;                  /* retrieved table entry */
+    unsigned op;                /* code bits, operation, extra bits, or */
+                                /*  window position, window bytes to copy */
+    unsigned len;               /* match length, unused bytes */
+    unsigned dist;              /* match distance */
+    unsigned copy;              /* bytes to copy from the window */
+    unsigned char FAR *from;    /* where to copy match from */
+
+    /* copy state to local variables */
+    state = (struct inflate_state FAR *)strm->state;
+    in = strm->next_in;
+    last = in + (strm->avail_in - (INFLATE_FAST_MIN_IN - 1));
+    if (in > last && strm->avail_in > INFLATE_FAST_MIN_IN - 1) {
+        /*
+         * overflow detected, limit strm->avail_in to the
+         * max. possible size and recalculate last
+         */
+        strm->avail_in = 0xffffffff - (uintptr_t)in;
+        last = in + (strm->avail_in - (INFLATE_FAST_MIN_IN - 1));
+    }
+    out = strm->next_out;
+    beg = out - (start - strm->avail_out);
+    end = out + (strm->avail_out - (INFLATE_FAST_MIN_OUT - 1));
+#ifdef INFLATE_STRICT
+    dmax = state->dmax;
+#endif
+    wsize = state->wsize;
+    whave = state->whave;
+    write = state->write;
+    window = state->window;
+    hold = state->hold;
+    bits = state->bits;
+    lcode = state->lencode;
+    dcode = state->distcode;
+    lmask = (1U << state->lenbits) - 1;
+    dmask = (1U << state->distbits) - 1;
+
+    /* decode literals and length/distances until end-of-block or not enough
+       input data or output space */
+    do {
+        if (bits < 48) {
+            hold |= inflate_load64(in) << bits;
+            in += (63 - bits) >> 3;
+            bits |= 56;
+        }
+        this = lcode[hold & lmask];
+      dolen:
+        op = (unsigned)(this.bits);
+        hold >>= op;
+        bits -= op;
+        op = (unsigned)(this.op);
+        if (op == 0) {                          /* literal */
+            Tracevv((stderr, this.val >= 0x20 && this.val < 0x7f ?
+                    "inflate:         literal '%c'\n" :
+                    "inflate:         literal 0x%02x\n", this.val));
+            *out++ = (unsigned char)(this.val);
+        }
+        else if (op & 16) {                     /* length base */
+            len = (unsigned)(this.val);
+            op &= 15;                           /* number of extra bits */
+            if (op) {
+                len += (unsigned)hold & ((1U << op) - 1);
+                hold >>= op;
+                bits -= op;
+            }
+            Tracevv((stderr, "inflate:         length %u\n", len));
+            this = dcode[hold & dmask];
+          dodist:
+            op = (unsigned)(this.bits);
+            hold >>= op;
+            bits -= op;
+            op = (unsigned)(this.op);
+            if (op & 16) {                      /* distance base */
+                dist = (unsigned)(this.val);
+                op &= 15;                       /* number of extra bits */
+                dist += (unsigned)hold & ((1U << op) - 1);
+#ifdef INFLATE_STRICT
+                if (dist > dmax) {
+                    strm->msg = (char *)"invalid distance too far back";
+                    state->mode = BAD;
+                    break;
+                }
+#endif
+                hold >>= op;
+                bits -= op;
+                Tracevv((stderr, "inflate:         distance %u\n", dist));
+                op = (unsigned)(out - beg);     /* max distance in output */
+                if (dist > op) {                /* see if copy from window */
+                    op = dist - op;             /* distance back in window */
+                    if (op > whave) {
+                        strm->msg = (char *)"invalid distance too far back";
+                        state->mode = BAD;
+                        break;
+                    }
+                    if (write < op) {           /* wrap around window */
+                        from = window + wsize + write - op;
+                        op -= write;            /* bytes at end of window */
+                        copy = op < len ? op : len;
+                        zmemcpy(out, from, copy);
+                        out += copy;
+                        len -= copy;
+                        from = window;          /* then start of window */
+                        op = write;
+                    }
+                    else {                      /* contiguous in window */
+                        from = window + write - op;
+                    }
+                    copy = op < len ? op : len;
+                    zmemcpy(out, from, copy);
+                    out += copy;
+                    len -= copy;
+                    if (len)                    /* rest from output */
+                        out = inflate_chunk_copy(out, dist, len);
+                }
+                else {                          /* copy direct from output */
+                    out = inflate_chunk_copy(out, dist, len);
+                }
+            }
+            else if ((op & 64) == 0) {          /* 2nd level distance code */
+                this = dcode[this.val + (hold & ((1U << op) - 1))];
+                goto dodist;
+            }
+            else {
+                strm->msg = (char *)"invalid distance code";
+                state->mode = BAD;
+                break;
+            }
+        }
+        else if ((op & 64) == 0) {              /* 2nd level length code */
+            this = lcode[this.val + (hold & ((1U << op) - 1))];
+            goto dolen;
+        }
+        else if (op & 32) {                     /* end-of-block */
+            Tracevv((stderr, "inflate:         end of block\n"));
+            state->mode = TYPE;
+            break;
+        }
+        else {
+            strm->msg = (char *)"invalid literal/length code";
+            state->mode = BAD;
+            break;
+        }
+    } while (in < last && out < end);
+
+    /* return unused bytes (on entry, bits < 8, so in won't go too far back) */
+    len = bits >> 3;
+    in -= len;
+    bits -= len << 3;
+    hold &= (1UL << bits) - 1;
+
+    /* update state and return */
+    strm->next_in = in;
+    strm->next_out = out;
+    strm->avail_in = (unsigned)(in < last ?
+                                (INFLATE_FAST_MIN_IN - 1) + (last - in) :
+                                (INFLATE_FAST_MIN_IN - 1) - (in - last));
+    strm->avail_out = (unsigned)(out < end ?
+                                 (INFLATE_FAST_MIN_OUT - 1) + (end - out) :
+                                 (INFLATE_FAST_MIN_OUT - 1) - (out - end));
+    state->hold = hold;
+    state->bits = bits;
+    return;
+}
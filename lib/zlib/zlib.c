@@ -25,7 +25,11 @@
 #include "inflate.h"
 #include "inffast.h"
 #include "inffixed.h"
+#if CONFIG_IS_ENABLED(ZLIB_INFLATE_FAST_WIDE)
+#include "inffast_wide.c"
+#else
 #include "inffast.c"
+#endif
 #include "inftrees.c"
 #include "inflate.c"
 #include "zutil.c"
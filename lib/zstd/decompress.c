@@ -919,7 +919,7 @@ size_t ZSTD_execSequenceLast7(BYTE *op, BYTE *const oend, seq_t sequence, const
 	return sequenceLength;
 }
 
-static seq_t ZSTD_decodeSequence(seqState_t *seqState)
+FORCE_INLINE seq_t ZSTD_decodeSequence(seqState_t *seqState)
 {
 	seq_t seq;
 
@@ -11,8 +11,48 @@
 #include <malloc.h>
 #include <linux/zstd.h>
 
-int zstd_decompress(struct abuf *in, struct abuf *out)
+/*
+ * The one-shot decompression context has a fixed size, so it is allocated
+ * once and kept for every later image. SPL's simple malloc() never frees,
+ * which would otherwise cost ~160KiB of the pool per image.
+ */
+static void *zstd_dctx_arena;
+
+static int zstd_decompress_dctx(struct abuf *in, struct abuf *out)
+{
+	ZSTD_DCtx *dctx;
+	size_t wsize, res;
+
+	wsize = ZSTD_DCtxWorkspaceBound();
+	if (!zstd_dctx_arena) {
+		zstd_dctx_arena = malloc(wsize);
+		if (!zstd_dctx_arena) {
+			debug("%s: cannot allocate workspace of size %zu\n",
+			      __func__, wsize);
+			return -ENOMEM;
+		}
+	}
+
+	dctx = ZSTD_initDCtx(zstd_dctx_arena, wsize);
+	if (!dctx) {
+		log_err("%s: ZSTD_initDCtx failed\n", __func__);
+		return -EPERM;
+	}
+
+	res = ZSTD_decompressDCtx(dctx, abuf_data(out), abuf_size(out),
+				  abuf_data(in), abuf_size(in));
+	if (ZSTD_isError(res)) {
+		log_err("ZSTD_decompressDCtx error %d\n",
+			ZSTD_getErrorCode(res));
+		return -EIO;
+	}
+
+	return res;
+}
+
+static int zstd_decompress_stream(struct abuf *in, struct abuf *out)
 {
+	ZSTD_frameParams params;
 	ZSTD_DStream *dstream;
 	ZSTD_inBuffer in_buf;
 	ZSTD_outBuffer out_buf;
@@ -20,7 +60,13 @@ int zstd_decompress(struct abuf *in, struct abuf *out)
 	size_t wsize;
 	int ret;
 
-	wsize = ZSTD_DStreamWorkspaceBound(abuf_size(in));
+	if (ZSTD_getFrameParams(&params, abuf_data(in), abuf_size(in)) ||
+	    !params.windowSize) {
+		log_err("%s: bad frame header\n", __func__);
+		return -EINVAL;
+	}
+
+	wsize = ZSTD_DStreamWorkspaceBound(params.windowSize);
 	workspace = malloc(wsize);
 	if (!workspace) {
 		debug("%s: cannot allocate workspace of size %zu\n", __func__,
@@ -28,7 +74,7 @@ int zstd_decompress(struct abuf *in, struct abuf *out)
 		return -ENOMEM;
 	}
 
-	dstream = ZSTD_initDStream(abuf_size(in), workspace, wsize);
+	dstream = ZSTD_initDStream(params.windowSize, workspace, wsize);
 	if (!dstream) {
 		log_err("%s: ZSTD_initDStream failed\n", __func__);
 		ret = -EPERM;
@@ -44,17 +90,25 @@ int zstd_decompress(struct abuf *in, struct abuf *out)
 	out_buf.size = abuf_size(out);
 
 	while (1) {
+		size_t in_pos = in_buf.pos, out_pos = out_buf.pos;
 		size_t res;
 
 		res = ZSTD_decompressStream(dstream, &out_buf, &in_buf);
 		if (ZSTD_isError(res)) {
-			ret = ZSTD_getErrorCode(res);
-			log_err("ZSTD_decompressStream error %d\n", ret);
+			log_err("ZSTD_decompressStream error %d\n",
+				ZSTD_getErrorCode(res));
+			ret = -EIO;
 			goto do_free;
 		}
 
 		if (in_buf.pos >= abuf_size(in) || !res)
 			break;
+		/* The output is full */
+		if (in_buf.pos == in_pos && out_buf.pos == out_pos) {
+			log_err("%s: output buffer too small\n", __func__);
+			ret = -ENOSPC;
+			goto do_free;
+		}
 	}
 
 	ret = out_buf.pos;
@@ -62,3 +116,30 @@ do_free:
 	free(workspace);
 	return ret;
 }
+
+int zstd_decompress(struct abuf *in, struct abuf *out)
+{
+	unsigned long long size;
+
+	/*
+	 * When the frames record their size, decode them straight into the
+	 * output. That needs no window buffer and saves copying every byte
+	 * through it.
+	 */
+	size = ZSTD_findDecompressedSize(abuf_data(in), abuf_size(in));
+	if (size == ZSTD_CONTENTSIZE_ERROR) {
+		log_err("%s: bad frame header\n", __func__);
+		return -EINVAL;
+	}
+	if (size != ZSTD_CONTENTSIZE_UNKNOWN) {
+		if (size > abuf_size(out)) {
+			log_err("%s: %llu bytes do not fit in %zu\n", __func__,
+				size, abuf_size(out));
+			return -ENOSPC;
+		}
+
+		return zstd_decompress_dctx(in, out);
+	}
+
+	return zstd_decompress_stream(in, out);
+}
@@ -20,6 +20,10 @@
 #ifdef CONFIG_SYS_DIRECT_FLASH_TFTP
 #include <flash.h>
 #endif
+#ifdef CONFIG_TFTP_BLK_WRITE
+#include <blk.h>
+#include <part.h>
+#endif
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -92,6 +96,17 @@ static ulong	tftp_load_addr;
 #ifdef CONFIG_LMB
 static ulong	tftp_load_size;
 #endif
+#ifdef CONFIG_TFTP_BLK_WRITE
+/* Block device the download is streamed to, NULL to load into memory */
+static struct blk_desc *tftp_blk_desc;
+/* First block and size of the area on tftp_blk_desc */
+static lbaint_t	tftp_blk_start;
+static lbaint_t	tftp_blk_count;
+/* True if the area is a partition rather than the whole device */
+static bool	tftp_blk_part;
+/* Number of blocks already written to tftp_blk_desc */
+static lbaint_t	tftp_blk_done;
+#endif
 #ifdef CONFIG_TFTP_TSIZE
 /* The file size reported by the server */
 static int	tftp_tsize;
@@ -158,6 +173,114 @@ static unsigned short tftp_block_size = TFTP_BLOCK_SIZE;
 static unsigned short tftp_block_size_option = CONFIG_TFTP_BLOCKSIZE;
 static unsigned short tftp_window_size_option = TFTP_WINDOWSIZE;
 
+#ifdef CONFIG_TFTP_BLK_WRITE
+int tftp_set_blk_target(struct blk_desc *desc, lbaint_t start,
+			lbaint_t count, bool part)
+{
+	if (desc && CONFIG_TFTP_BLK_WRITE_BUF_SIZE % desc->blksz) {
+		printf("TFTP staging buffer size 0x%x is not a multiple of the block size %lu\n",
+		       CONFIG_TFTP_BLK_WRITE_BUF_SIZE, desc->blksz);
+		return -EINVAL;
+	}
+
+	tftp_blk_desc = desc;
+	tftp_blk_start = start;
+	tftp_blk_count = count;
+	tftp_blk_part = part;
+	tftp_blk_done = 0;
+
+	return 0;
+}
+
+/*
+ * Check whether the first blocks of a download carry a partition table,
+ * a DOS MBR or a GPT header, so that they are a whole-disk image
+ */
+static bool tftp_blk_is_disk_image(void *buf, ulong len)
+{
+	ulong blksz = tftp_blk_desc->blksz;
+
+	if (CONFIG_IS_ENABLED(DOS_PARTITION) && len >= blksz &&
+	    !is_valid_dos_buf(buf))
+		return true;
+
+	return len >= 2 * blksz && !memcmp(buf + blksz, "EFI PART", 8);
+}
+
+/*
+ * Write the first len bytes of the staging buffer to the block device,
+ * padding a partial last block with zeros.
+ */
+static int tftp_blk_flush(ulong len)
+{
+	ulong blksz = tftp_blk_desc->blksz;
+	lbaint_t blkcnt = DIV_ROUND_UP(len, blksz);
+	ulong written;
+	void *buf;
+
+	if (!blkcnt)
+		return 0;
+
+	if (tftp_blk_done + blkcnt > tftp_blk_count) {
+		puts("\nTFTP error: file does not fit on the target device\n");
+		return -ENOSPC;
+	}
+
+	buf = map_sysmem(tftp_load_addr, blkcnt * blksz);
+	memset(buf + len, 0, blkcnt * blksz - len);
+	if (!tftp_blk_done && tftp_blk_part &&
+	    tftp_blk_is_disk_image(buf, len)) {
+		unmap_sysmem(buf);
+		puts("\nTFTP error: whole-disk image aimed at a partition, use <dev>:0\n");
+		return -EINVAL;
+	}
+	written = blk_dwrite(tftp_blk_desc, tftp_blk_start + tftp_blk_done,
+			     blkcnt, buf);
+	unmap_sysmem(buf);
+	if (written != blkcnt) {
+		printf("\nTFTP error: write failed at block " LBAFU "\n",
+		       tftp_blk_start + tftp_blk_done);
+		return -EIO;
+	}
+	tftp_blk_done += blkcnt;
+
+	return 0;
+}
+
+/*
+ * Blocks arrive in order, so everything before tftp_blk_done has been
+ * written out and the staging buffer holds the data that follows it.
+ */
+static int tftp_blk_store(ulong offset, uchar *src, unsigned int len)
+{
+	ulong staged = offset - tftp_blk_done * tftp_blk_desc->blksz;
+	unsigned int chunk;
+	void *ptr;
+	int ret;
+
+	while (len) {
+		if (staged == CONFIG_TFTP_BLK_WRITE_BUF_SIZE) {
+			ret = tftp_blk_flush(staged);
+			if (ret)
+				return ret;
+			staged = 0;
+		}
+
+		chunk = min_t(ulong, len,
+			      CONFIG_TFTP_BLK_WRITE_BUF_SIZE - staged);
+		ptr = map_sysmem(tftp_load_addr + staged, chunk);
+		memcpy(ptr, src, chunk);
+		unmap_sysmem(ptr);
+
+		staged += chunk;
+		src += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_TFTP_BLK_WRITE */
+
 static inline int store_block(int block, uchar *src, unsigned int len)
 {
 	ulong offset = block * tftp_block_size + tftp_block_wrap_offset -
@@ -185,6 +308,12 @@ static inline int store_block(int block, uchar *src, unsigned int len)
 		}
 	} else
 #endif /* CONFIG_SYS_DIRECT_FLASH_TFTP */
+#ifdef CONFIG_TFTP_BLK_WRITE
+	if (tftp_blk_desc) {
+		if (tftp_blk_store(offset, src, len))
+			return -1;
+	} else
+#endif
 	{
 		void *ptr;
 
@@ -221,6 +350,9 @@ static void new_transfer(void)
 #ifdef CONFIG_CMD_TFTPPUT
 	tftp_put_final_block_sent = 0;
 #endif
+#ifdef CONFIG_TFTP_BLK_WRITE
+	tftp_blk_done = 0;
+#endif
 }
 
 #ifdef CONFIG_CMD_TFTPPUT
@@ -329,6 +461,18 @@ static void tftp_complete(void)
 		print_size(net_boot_file_size /
 			time_start * 1000, "/s");
 	}
+#ifdef CONFIG_TFTP_BLK_WRITE
+	if (tftp_blk_desc) {
+		/* Write out whatever is left in the staging buffer */
+		if (tftp_blk_flush(net_boot_file_size -
+				   tftp_blk_done * tftp_blk_desc->blksz)) {
+			eth_halt();
+			net_set_state(NETLOOP_FAIL);
+			return;
+		}
+		printf("\n\t " LBAFU " blocks written", tftp_blk_done);
+	}
+#endif
 	puts("\ndone\n");
 	if (IS_ENABLED(CONFIG_CMD_BOOTEFI)) {
 		if (!tftp_put_active)
@@ -734,6 +878,10 @@ static int tftp_init_load_addr(void)
 		return -1;
 
 	tftp_load_size = max_size;
+#ifdef CONFIG_TFTP_BLK_WRITE
+	if (tftp_blk_desc && max_size < CONFIG_TFTP_BLK_WRITE_BUF_SIZE)
+		return -1;
+#endif
 #endif
 	tftp_load_addr = image_load_addr;
 	return 0;
@@ -846,6 +994,11 @@ void tftp_start(enum proto_t protocol)
 			return;
 		}
 		printf("Load address: 0x%lx\n", tftp_load_addr);
+#ifdef CONFIG_TFTP_BLK_WRITE
+		if (tftp_blk_desc)
+			printf("Writing to:   block " LBAFU ", " LBAFU " blocks\n",
+			       tftp_blk_start, tftp_blk_count);
+#endif
 		puts("Loading: *\b");
 		tftp_state = STATE_SEND_RRQ;
 	}
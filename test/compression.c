@@ -4,6 +4,7 @@
  */
 
 #include <common.h>
+#include <abuf.h>
 #include <bootm.h>
 #include <command.h>
 #include <gzip.h>
@@ -11,6 +12,8 @@
 #include <log.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <rand.h>
+#include <time.h>
 #include <asm/io.h>
 
 #include <u-boot/lz4.h>
@@ -22,6 +25,9 @@
 #include <lzma/LzmaTools.h>
 
 #include <linux/lzo.h>
+#include <linux/math64.h>
+#include <linux/sizes.h>
+#include <linux/zstd.h>
 #include <test/compression.h>
 #include <test/suites.h>
 #include <test/ut.h>
@@ -121,6 +127,40 @@ static const char lz4_compressed[] =
 	"\x9d\x12\x8c\x9d";
 static const unsigned long lz4_compressed_size = 276;
 
+/* zstd -19 --zstd=wlog=10 -c /tmp/plain.txt > /tmp/plain.zst */
+static const char zstd_compressed[] =
+	"\x28\xb5\x2f\xfd\x64\x5e\x00\xad\x05\x00\x42\x4e\x26\x17\x90\x3b"
+	"\x07\x04\x5a\x13\x8b\xa7\x65\x34\x12\x21\x6d\xb0\x39\xbb\xae\xe8"
+	"\xba\xc9\xcd\x5e\x02\x49\xd0\x2b\xa9\xfa\x96\x92\xe7\x1f\x19\x19"
+	"\x7c\x8f\xf1\x9d\x54\x37\xfc\xd6\x0a\xf3\x0c\x93\x56\xc7\x52\x4f"
+	"\x0a\x62\x3e\xd1\xa5\x83\x17\x31\xab\x5d\x8f\x57\xf3\xcc\x3b\x58"
+	"\xf8\x91\x8c\xf1\x2a\x5c\x89\xdd\xf2\x9b\x15\xb7\x92\x5b\xbe\xba"
+	"\xab\xd5\xd1\x34\xdf\xf0\x02\x0e\x61\xcd\x7b\xd6\x01\xfc\xc2\xa7"
+	"\xd4\xd1\x3d\x26\x9c\x10\x49\xb8\x5b\xcd\xba\x7c\xf7\xac\x4b\xad"
+	"\xb7\x31\x1c\xbc\xf9\xcb\x62\x8e\x2e\x9b\x0f\xd3\x87\x57\x45\x12"
+	"\x16\xfa\x3a\x79\xde\x65\xf8\xcc\x48\xd5\x43\xa6\xbd\xc3\x91\x29"
+	"\x65\x29\xa7\x5b\x9a\x08\x08\x00\x60\x13\x00\x63\xa3\x8e\x28\x94"
+	"\x79\x41\x2a\x78\xc2\x91\x70\x9f\xaa\x6a\x21\x7a\xa1\xaa\x0c\xe4"
+	"\xf4\x6e\xfa";
+static const unsigned long zstd_compressed_size = 195;
+
+/* The same from a pipe, which leaves the content size out of the header */
+static const char zstd_stream_compressed[] =
+	"\x28\xb5\x2f\xfd\x04\x00\xad\x05\x00\x42\x4e\x26\x17\x90\x3b\x07"
+	"\x04\x5a\x13\x8b\xa7\x65\x34\x12\x21\x6d\xb0\x39\xbb\xae\xe8\xba"
+	"\xc9\xcd\x5e\x02\x49\xd0\x2b\xa9\xfa\x96\x92\xe7\x1f\x19\x19\x7c"
+	"\x8f\xf1\x9d\x54\x37\xfc\xd6\x0a\xf3\x0c\x93\x56\xc7\x52\x4f\x0a"
+	"\x62\x3e\xd1\xa5\x83\x17\x31\xab\x5d\x8f\x57\xf3\xcc\x3b\x58\xf8"
+	"\x91\x8c\xf1\x2a\x5c\x89\xdd\xf2\x9b\x15\xb7\x92\x5b\xbe\xba\xab"
+	"\xd5\xd1\x34\xdf\xf0\x02\x0e\x61\xcd\x7b\xd6\x01\xfc\xc2\xa7\xd4"
+	"\xd1\x3d\x26\x9c\x10\x49\xb8\x5b\xcd\xba\x7c\xf7\xac\x4b\xad\xb7"
+	"\x31\x1c\xbc\xf9\xcb\x62\x8e\x2e\x9b\x0f\xd3\x87\x57\x45\x12\x16"
+	"\xfa\x3a\x79\xde\x65\xf8\xcc\x48\xd5\x43\xa6\xbd\xc3\x91\x29\x65"
+	"\x29\xa7\x5b\x9a\x08\x08\x00\x60\x13\x00\x63\xa3\x8e\x28\x94\x79"
+	"\x41\x2a\x78\xc2\x91\x70\x9f\xaa\x6a\x21\x7a\xa1\xaa\x0c\xe4\xf4"
+	"\x6e\xfa";
+static const unsigned long zstd_stream_compressed_size = 194;
+
 
 #define TEST_BUFFER_SIZE	512
 
@@ -296,6 +336,61 @@ static int uncompress_using_lz4(struct unit_test_state *uts,
 	return (ret != 0);
 }
 
+static int fake_compress(struct unit_test_state *uts, void *in,
+			 unsigned long in_size, void *out,
+			 unsigned long out_max, unsigned long *out_size,
+			 const char *compressed, unsigned long compressed_size)
+{
+	ut_asserteq(in_size, strlen(plain));
+	ut_asserteq_mem(plain, in, in_size);
+
+	if (compressed_size > out_max)
+		return -1;
+
+	memcpy(out, compressed, compressed_size);
+	if (out_size)
+		*out_size = compressed_size;
+
+	return 0;
+}
+
+static int compress_using_zstd(struct unit_test_state *uts,
+			       void *in, unsigned long in_size,
+			       void *out, unsigned long out_max,
+			       unsigned long *out_size)
+{
+	/* There is no zstd compression in u-boot, so fake it. */
+	return fake_compress(uts, in, in_size, out, out_max, out_size,
+			     zstd_compressed, zstd_compressed_size);
+}
+
+static int compress_using_zstd_stream(struct unit_test_state *uts,
+				      void *in, unsigned long in_size,
+				      void *out, unsigned long out_max,
+				      unsigned long *out_size)
+{
+	return fake_compress(uts, in, in_size, out, out_max, out_size,
+			     zstd_stream_compressed,
+			     zstd_stream_compressed_size);
+}
+
+static int uncompress_using_zstd(struct unit_test_state *uts,
+				 void *in, unsigned long in_size,
+				 void *out, unsigned long out_max,
+				 unsigned long *out_size)
+{
+	struct abuf inb, outb;
+	int ret;
+
+	abuf_init_set(&inb, in, in_size);
+	abuf_init_set(&outb, out, out_max);
+	ret = zstd_decompress(&inb, &outb);
+	if (out_size)
+		*out_size = max(ret, 0);
+
+	return ret < 0;
+}
+
 #define errcheck(statement) if (!(statement)) { \
 	fprintf(stderr, "\tFailed: %s\n", #statement); \
 	ret = 1; \
@@ -440,6 +535,183 @@ static int compression_test_lz4(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_lz4, 0);
 
+static int compression_test_zstd(struct unit_test_state *uts)
+{
+	return run_test(uts, "zstd", compress_using_zstd,
+			uncompress_using_zstd);
+}
+COMPRESSION_TEST(compression_test_zstd, 0);
+
+static int compression_test_zstd_stream(struct unit_test_state *uts)
+{
+	return run_test(uts, "zstd_stream", compress_using_zstd_stream,
+			uncompress_using_zstd);
+}
+COMPRESSION_TEST(compression_test_zstd_stream, 0);
+
+#define GUNZIP_BENCH_SIZE	SZ_4M
+#define GUNZIP_BENCH_LOOPS	4
+
+/*
+ * Time gunzip() on a few MiB of text-like data, which exercises literals,
+ * short and long match distances and the sliding window
+ */
+static int compression_test_gunzip_bench(struct unit_test_state *uts)
+{
+	unsigned long comp_size, size;
+	char *orig, *uncomp;
+	ulong start, us;
+	u8 *comp;
+	int i, pos;
+
+	orig = malloc(GUNZIP_BENCH_SIZE);
+	comp = malloc(GUNZIP_BENCH_SIZE);
+	uncomp = malloc(GUNZIP_BENCH_SIZE);
+	ut_assertnonnull(orig);
+	ut_assertnonnull(comp);
+	ut_assertnonnull(uncomp);
+
+	for (pos = 0, i = 0; pos < GUNZIP_BENCH_SIZE; i++) {
+		pos += snprintf(orig + pos, GUNZIP_BENCH_SIZE - pos,
+				"%08x %s", rand() % (i + 1),
+				plain + (i % 7) * 11);
+	}
+
+	comp_size = GUNZIP_BENCH_SIZE;
+	ut_assertok(gzip(comp, &comp_size, (u8 *)orig, GUNZIP_BENCH_SIZE));
+
+	start = timer_get_us();
+	for (i = 0; i < GUNZIP_BENCH_LOOPS; i++) {
+		size = comp_size;
+		ut_assertok(gunzip(uncomp, GUNZIP_BENCH_SIZE, comp, &size));
+	}
+	us = max(timer_get_us() - start, 1UL);
+	ut_asserteq(GUNZIP_BENCH_SIZE, size);
+	ut_assertok(memcmp(orig, uncomp, GUNZIP_BENCH_SIZE));
+
+	printf("gunzip %lu -> %u bytes: %lu us, %llu KiB/s\n", comp_size,
+	       GUNZIP_BENCH_SIZE, us / GUNZIP_BENCH_LOOPS,
+	       div_u64((u64)GUNZIP_BENCH_SIZE * GUNZIP_BENCH_LOOPS * 1000000 /
+		       1024, us));
+
+	free(uncomp);
+	free(comp);
+	free(orig);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_gunzip_bench, 0);
+
+#define INFLATE_STREAM_SIZE	SZ_128K
+#define INFLATE_STREAM_GUARD	16
+
+/*
+ * Inflate @comp the way gzwrite() does, @out_chunk bytes at a time into a
+ * reused buffer, feeding the input @in_chunk bytes at a time. Check each
+ * chunk against @orig and that nothing is written past the chunk.
+ */
+static int inflate_in_chunks(struct unit_test_state *uts, const char *orig,
+			     u8 *comp, unsigned long comp_size, uint in_chunk,
+			     uint out_chunk)
+{
+	unsigned long done = 0, left;
+	uint n;
+	z_stream s;
+	int offset, r;
+	u8 *buf;
+
+	offset = gzip_parse_header(comp, comp_size);
+	ut_assert(offset > 0);
+	/* The CRC and size trailer is not part of the deflate stream */
+	left = comp_size - offset - 8;
+
+	buf = malloc(out_chunk + INFLATE_STREAM_GUARD);
+	ut_assertnonnull(buf);
+
+	memset(&s, '\0', sizeof(s));
+	s.zalloc = gzalloc;
+	s.zfree = gzfree;
+	ut_asserteq(Z_OK, inflateInit2(&s, -MAX_WBITS));
+	s.next_in = comp + offset;
+
+	do {
+		if (!s.avail_in) {
+			s.avail_in = min_t(unsigned long, in_chunk, left);
+			left -= s.avail_in;
+		}
+		memset(buf, 0xa5, out_chunk + INFLATE_STREAM_GUARD);
+		s.next_out = buf;
+		s.avail_out = out_chunk;
+		r = inflate(&s, Z_SYNC_FLUSH);
+		ut_assert(r == Z_OK || r == Z_STREAM_END);
+
+		n = out_chunk - s.avail_out;
+		ut_assert(done + n <= INFLATE_STREAM_SIZE);
+		ut_asserteq_mem(orig + done, buf, n);
+		ut_assertnull(memchr_inv(buf + out_chunk, 0xa5,
+					 INFLATE_STREAM_GUARD));
+		done += n;
+	} while (r != Z_STREAM_END);
+	ut_asserteq(INFLATE_STREAM_SIZE, done);
+
+	inflateEnd(&s);
+	free(buf);
+
+	return 0;
+}
+
+/*
+ * Inflate with small output chunks, so that matches reach back into the
+ * window kept from earlier calls and the fast decoder runs with output
+ * space close to its minimum. Small input chunks make it hand back bytes
+ * it read ahead at the end of each call.
+ */
+static int compression_test_inflate_stream(struct unit_test_state *uts)
+{
+	static const uint out_chunks[] = {
+		1, 100, 258, 259, 272, 273, 274, 300, 4096
+	};
+	unsigned long comp_size;
+	int i, pos, len, dist;
+	char *orig;
+	u8 *comp;
+
+	orig = malloc(INFLATE_STREAM_SIZE);
+	comp = malloc(INFLATE_STREAM_SIZE);
+	ut_assertnonnull(orig);
+	ut_assertnonnull(comp);
+
+	/* Text-like data with repeats from up to the whole 32KiB window */
+	for (pos = 0, i = 0; pos < INFLATE_STREAM_SIZE; i++) {
+		dist = 8000 + (i * 997) % 24000;
+		if (i % 16 == 15 && pos >= dist) {
+			len = min(1000, INFLATE_STREAM_SIZE - pos);
+			memcpy(orig + pos, orig + pos - dist, len);
+			pos += len;
+			continue;
+		}
+		pos += snprintf(orig + pos, INFLATE_STREAM_SIZE - pos,
+				"%08x %s", rand() % (i + 1),
+				plain + (i % 7) * 11);
+	}
+
+	comp_size = INFLATE_STREAM_SIZE;
+	ut_assertok(gzip(comp, &comp_size, (u8 *)orig, INFLATE_STREAM_SIZE));
+
+	for (i = 0; i < ARRAY_SIZE(out_chunks); i++) {
+		ut_assertok(inflate_in_chunks(uts, orig, comp, comp_size, 13,
+					      out_chunks[i]));
+		ut_assertok(inflate_in_chunks(uts, orig, comp, comp_size,
+					      comp_size, out_chunks[i]));
+	}
+
+	free(comp);
+	free(orig);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_inflate_stream, 0);
+
 static int compress_using_none(struct unit_test_state *uts,
 			       void *in, unsigned long in_size,
 			       void *out, unsigned long out_max,
@@ -530,6 +802,12 @@ static int compression_test_bootm_lz4(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_bootm_lz4, 0);
 
+static int compression_test_bootm_zstd(struct unit_test_state *uts)
+{
+	return run_bootm_test(uts, IH_COMP_ZSTD, compress_using_zstd);
+}
+COMPRESSION_TEST(compression_test_bootm_zstd, 0);
+
 static int compression_test_bootm_none(struct unit_test_state *uts)
 {
 	return run_bootm_test(uts, IH_COMP_NONE, compress_using_none);
@@ -11,8 +11,10 @@
 #include <fdtdec.h>
 #include <log.h>
 #include <malloc.h>
+#include <time.h>
 #include <asm/global_data.h>
 #include <dm/device-internal.h>
+#include <dm/lists.h>
 #include <dm/root.h>
 #include <dm/util.h>
 #include <dm/test.h>
@@ -1000,6 +1002,194 @@ static int dm_test_uclass_before_ready(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_uclass_before_ready, 0);
 
+/* Look up every uclass ID @rounds times, returning the time taken in us */
+static ulong dm_test_uclass_find_all(int rounds)
+{
+	ulong start;
+	int i, id;
+
+	start = timer_get_us();
+	for (i = 0; i < rounds; i++) {
+		for (id = 0; id < UCLASS_COUNT; id++)
+			uclass_find(id);
+	}
+
+	return timer_get_us() - start;
+}
+
+/* Test that the uclass table agrees with the uclass list */
+static int dm_test_uclass_table(struct unit_test_state *uts)
+{
+	struct uclass **table = gd_uclass_table();
+	ulong table_us, list_us;
+	struct uclass *uc, *found;
+	int count, id;
+
+	if (!CONFIG_IS_ENABLED(DM_UCLASS_TABLE))
+		return -EAGAIN;
+	ut_assertnonnull(table);
+	ut_assertnull(uclass_find(UCLASS_INVALID));
+	ut_assertnull(uclass_find(UCLASS_COUNT));
+
+	count = 0;
+	for (id = 0; id < UCLASS_COUNT; id++) {
+		found = NULL;
+		list_for_each_entry(uc, gd->uclass_root, sibling_node) {
+			if (uc->uc_drv->id == id)
+				found = uc;
+		}
+		ut_asserteq_ptr(found, uclass_find(id));
+		if (found) {
+			ut_asserteq_ptr(found, table[id]);
+			count++;
+		}
+	}
+	ut_asserteq(list_count_items(gd->uclass_root), count);
+
+	/* Destroying a uclass must drop it from the table */
+	ut_assertok(uclass_get(UCLASS_TEST_DUMMY, &uc));
+	ut_asserteq_ptr(uc, table[UCLASS_TEST_DUMMY]);
+	ut_assertok(uclass_destroy(uc));
+	ut_assertnull(table[UCLASS_TEST_DUMMY]);
+	ut_assertnull(uclass_find(UCLASS_TEST_DUMMY));
+
+	table_us = dm_test_uclass_find_all(1000);
+	gd_set_uclass_table(NULL);
+	list_us = dm_test_uclass_find_all(1000);
+	gd_set_uclass_table(table);
+	printf("%d uclasses, %d lookups: table %lu us, list %lu us\n",
+	       count, 1000 * UCLASS_COUNT, table_us, list_us);
+
+	return 0;
+}
+DM_TEST(dm_test_uclass_table, UT_TESTF_SCAN_PDATA);
+
+/* Find the first driver matching @compat by walking the whole list */
+static struct driver *dm_test_compat_walk(const char *compat,
+					  const struct udevice_id **idp)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct udevice_id *id;
+	struct driver *entry;
+
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (id = entry->of_match; id && id->compatible; id++) {
+			if (!strcmp(id->compatible, compat)) {
+				*idp = id;
+				return entry;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/* Test that compatible lookups find the first matching driver in the list */
+static int dm_test_lists_compat(struct unit_test_state *uts)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct udevice_id *id, *found_id, *walk_id;
+	struct driver *entry, *found;
+	int count = 0;
+
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (id = entry->of_match; id && id->compatible; id++) {
+			found = lists_driver_lookup_compat(id->compatible,
+							   &found_id);
+			ut_asserteq_ptr(dm_test_compat_walk(id->compatible,
+							    &walk_id), found);
+			ut_asserteq_ptr(walk_id, found_id);
+			count++;
+		}
+	}
+	ut_assert(count > 0);
+	ut_assertnull(lists_driver_lookup_compat("u-boot,no-such-driver",
+						 &found_id));
+
+	return 0;
+}
+DM_TEST(dm_test_lists_compat, 0);
+
+/* Look up @node @rounds times, returning the time taken in us */
+static ulong dm_test_ofnode_find_time(ofnode node, int rounds)
+{
+	struct udevice *dev;
+	ulong start;
+	int i;
+
+	start = timer_get_us();
+	for (i = 0; i < rounds; i++)
+		device_find_global_by_ofnode(node, &dev);
+
+	return timer_get_us() - start;
+}
+
+/* Test that lookups through the ofnode index match walking the devices */
+static int dm_test_ofnode_index(struct unit_test_state *uts)
+{
+	struct dm_ofnode_index *index = gd_dm_ofnode_index();
+	struct udevice *dev, *found, *walk, *ref;
+	ulong index_us, walk_us;
+	struct uclass *uc;
+	ofnode node;
+	int phandle;
+
+	if (!CONFIG_IS_ENABLED(DM_OFNODE_INDEX))
+		return -EAGAIN;
+	ut_assertnonnull(index);
+
+	list_for_each_entry(uc, gd->uclass_root, sibling_node) {
+		uclass_foreach_dev(dev, uc) {
+			node = dev_ofnode(dev);
+			if (!ofnode_valid(node))
+				continue;
+
+			ut_assertok(device_find_global_by_ofnode(node, &found));
+			ut_assertok(uclass_find_device_by_ofnode(uc->uc_drv->id,
+								 node, &ref));
+			gd_set_dm_ofnode_index(NULL);
+			ut_assertok(device_find_global_by_ofnode(node, &walk));
+			ut_asserteq_ptr(walk, found);
+			ut_assertok(uclass_find_device_by_ofnode(uc->uc_drv->id,
+								 node, &walk));
+			ut_asserteq_ptr(walk, ref);
+			gd_set_dm_ofnode_index(index);
+
+			phandle = dev_read_phandle(dev);
+			if (phandle <= 0)
+				continue;
+			uclass_foreach_dev(walk, uc) {
+				if (dev_read_phandle(walk) == phandle)
+					break;
+			}
+			ut_assertok(device_index_find_phandle(phandle,
+							      uc->uc_drv->id,
+							      &found));
+			ut_asserteq_ptr(walk, found);
+		}
+	}
+
+	/* Unbinding a device must drop it from the index */
+	node = ofnode_path("/a-test");
+	ut_assert(ofnode_valid(node));
+	ut_assertok(device_find_global_by_ofnode(node, &dev));
+	index_us = dm_test_ofnode_find_time(node, 1000);
+	gd_set_dm_ofnode_index(NULL);
+	walk_us = dm_test_ofnode_find_time(node, 1000);
+	gd_set_dm_ofnode_index(index);
+	printf("1000 lookups: index %lu us, walk %lu us\n", index_us, walk_us);
+
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_assertok(device_unbind(dev));
+	ut_asserteq(-ENOENT, device_find_global_by_ofnode(node, &dev));
+	ut_asserteq(0, device_index_find_ofnode(node, UCLASS_INVALID, &dev));
+
+	return 0;
+}
+DM_TEST(dm_test_ofnode_index, UT_TESTF_SCAN_FDT);
+
 static int dm_test_uclass_devices_find(struct unit_test_state *uts)
 {
 	struct udevice *dev;
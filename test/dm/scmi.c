@@ -16,6 +16,8 @@
 #include <clk.h>
 #include <dm.h>
 #include <reset.h>
+#include <scmi_agent.h>
+#include <scmi_protocols.h>
 #include <asm/scmi_test.h>
 #include <dm/device-internal.h>
 #include <dm/test.h>
@@ -176,6 +178,112 @@ static int dm_test_scmi_clocks(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_scmi_clocks, UT_TESTF_SCAN_FDT);
 
+/* Test that clock rates are only read from the SCMI server when needed */
+static int dm_test_scmi_clock_rate_cache(struct unit_test_state *uts)
+{
+	struct sandbox_scmi_devices *scmi_devices;
+	struct sandbox_scmi_agent *agent0;
+	struct udevice *dev = NULL;
+	uint count;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_CLK_SCMI_RATE_CACHE))
+		return -EAGAIN;
+
+	ret = load_sandbox_scmi_test_devices(uts, &dev);
+	if (ret)
+		return ret;
+
+	scmi_devices = sandbox_scmi_devices_ctx(dev);
+	agent0 = sandbox_scmi_service_ctx()->agent[0];
+
+	/* A clock is described on its first read, then a fixed rate is known */
+	count = agent0->msg_count;
+	ut_asserteq(1000, clk_get_rate(&scmi_devices->clk[0]));
+	ut_asserteq(1000, clk_get_rate(&scmi_devices->clk[0]));
+	ut_asserteq(count + 1, agent0->msg_count);
+
+	/* Other clocks are described, then read once */
+	count = agent0->msg_count;
+	ut_asserteq(333, clk_get_rate(&scmi_devices->clk[1]));
+	ut_asserteq(333, clk_get_rate(&scmi_devices->clk[1]));
+	ut_asserteq(count + 2, agent0->msg_count);
+
+	/* Gating a clock does not change rates */
+	ut_assertok(clk_enable(&scmi_devices->clk[1]));
+	count = agent0->msg_count;
+	ut_asserteq(333, clk_get_rate(&scmi_devices->clk[1]));
+	ut_asserteq(count, agent0->msg_count);
+
+	/* Setting the rate reads it back once */
+	ret = clk_set_rate(&scmi_devices->clk[1], 1088);
+	ut_assert(!ret || ret == 1088);
+	ut_asserteq(1088, clk_get_rate(&scmi_devices->clk[1]));
+	ut_asserteq(count + 2, agent0->msg_count);
+
+	/* The fixed rate stays known, and cannot be changed */
+	ut_asserteq(1000, clk_get_rate(&scmi_devices->clk[0]));
+	ut_asserteq(count + 2, agent0->msg_count);
+	ut_assert(IS_ERR_VALUE(clk_set_rate(&scmi_devices->clk[0], 10)));
+	ut_asserteq(1000, clk_get_rate(&scmi_devices->clk[0]));
+
+	ret = clk_set_rate(&scmi_devices->clk[1], 333);
+	ut_assert(!ret || ret == 333);
+	ut_assertok(clk_disable(&scmi_devices->clk[1]));
+
+	return release_sandbox_scmi_test_devices(uts, dev);
+}
+DM_TEST(dm_test_scmi_clock_rate_cache, UT_TESTF_SCAN_FDT);
+
+/* Test that messages sent together share the agent doorbells */
+static int dm_test_scmi_batch(struct unit_test_state *uts)
+{
+	struct sandbox_scmi_devices *scmi_devices;
+	struct sandbox_scmi_agent *agent0;
+	struct scmi_clk_rate_get_in in[6];
+	struct scmi_clk_rate_get_out out[6];
+	struct scmi_msg msgs[6];
+	struct udevice *agent_dev;
+	struct udevice *dev = NULL;
+	uint msg_count, doorbell_count;
+	int i, ret;
+
+	ret = load_sandbox_scmi_test_devices(uts, &dev);
+	if (ret)
+		return ret;
+
+	scmi_devices = sandbox_scmi_devices_ctx(dev);
+	agent0 = sandbox_scmi_service_ctx()->agent[0];
+	agent_dev = scmi_devices->clk[0].dev->parent;
+
+	/* Read the rates of clocks 7 and 3 of agent 0, three times each */
+	for (i = 0; i < ARRAY_SIZE(msgs); i++) {
+		in[i].clock_id = i % 2 ? 3 : 7;
+		msgs[i] = SCMI_MSG_IN(SCMI_PROTOCOL_ID_CLOCK,
+				      SCMI_CLOCK_RATE_GET, in[i], out[i]);
+	}
+
+	/* The sandbox agent takes 4 messages per doorbell */
+	msg_count = agent0->msg_count;
+	doorbell_count = agent0->doorbell_count;
+	ut_assertok(devm_scmi_process_msgs(agent_dev, msgs, ARRAY_SIZE(msgs)));
+	ut_asserteq(msg_count + 6, agent0->msg_count);
+	ut_asserteq(doorbell_count + 2, agent0->doorbell_count);
+
+	for (i = 0; i < ARRAY_SIZE(msgs); i++) {
+		ut_asserteq(SCMI_SUCCESS, out[i].status);
+		ut_asserteq(i % 2 ? 333 : 1000, out[i].rate_lsb);
+		ut_asserteq(0, out[i].rate_msb);
+	}
+
+	/* A single message still costs one doorbell */
+	ut_assertok(devm_scmi_process_msg(agent_dev, &msgs[0]));
+	ut_asserteq(doorbell_count + 3, agent0->doorbell_count);
+
+	return release_sandbox_scmi_test_devices(uts, dev);
+}
+DM_TEST(dm_test_scmi_batch, UT_TESTF_SCAN_FDT);
+
 static int dm_test_scmi_resets(struct unit_test_state *uts)
 {
 	struct sandbox_scmi_devices *scmi_devices;
@@ -7,13 +7,16 @@
 #include <common.h>
 #include <command.h>
 #include <log.h>
+#include <malloc.h>
 #include <search.h>
 #include <stdio.h>
+#include <time.h>
 #include <test/env.h>
 #include <test/ut.h>
 
 #define SIZE 32
 #define ITERATIONS 10000
+#define BENCH_SIZE 1000
 
 static int htab_fill(struct unit_test_state *uts,
 		     struct hsearch_data *htab, size_t size)
@@ -124,3 +127,68 @@ static int env_test_htab_deletes(struct unit_test_state *uts)
 }
 
 ENV_TEST(env_test_htab_deletes, 0);
+
+/*
+ * Time lookups and an export/import round trip of a large table, and check
+ * that the export is sorted by name
+ */
+static int env_test_htab_bench(struct unit_test_state *uts)
+{
+	struct hsearch_data htab;
+	ulong start, fill_us, find_us, export_us, import_us;
+	char *res = NULL, *prev, *line, *next;
+	size_t prev_len, key_len;
+	ssize_t len;
+	int i, cmp;
+
+	memset(&htab, 0, sizeof(htab));
+	ut_asserteq(1, hcreate_r(BENCH_SIZE, &htab));
+
+	start = timer_get_us();
+	ut_assertok(htab_fill(uts, &htab, BENCH_SIZE));
+	fill_us = timer_get_us() - start;
+
+	start = timer_get_us();
+	for (i = 0; i < 10; i++)
+		ut_assertok(htab_check_fill(uts, &htab, BENCH_SIZE));
+	find_us = timer_get_us() - start;
+
+	start = timer_get_us();
+	len = hexport_r(&htab, '\n', 0, &res, 0, 0, NULL);
+	export_us = timer_get_us() - start;
+	ut_assert(len > 0);
+
+	prev = NULL;
+	prev_len = 0;
+	for (line = res; line && *line; line = next) {
+		next = strchr(line, '\n');
+		if (next)
+			next++;
+		key_len = strchr(line, '=') - line;
+		if (prev) {
+			cmp = strncmp(prev, line, min(prev_len, key_len));
+			ut_assert(cmp < 0 || (!cmp && prev_len < key_len));
+		}
+		prev = line;
+		prev_len = key_len;
+	}
+
+	/* Import into a table of the same size, the default one is smaller */
+	hdestroy_r(&htab);
+	ut_asserteq(1, hcreate_r(BENCH_SIZE, &htab));
+	start = timer_get_us();
+	ut_asserteq(1, himport_r(&htab, res, len, '\n', H_NOCLEAR, 0, 0,
+				 NULL));
+	import_us = timer_get_us() - start;
+	ut_assertok(htab_check_fill(uts, &htab, BENCH_SIZE));
+	free(res);
+
+	printf("%d entries: fill %lu us, 10x find %lu us, export %lu us, ",
+	       BENCH_SIZE, fill_us, find_us, export_us);
+	printf("import %lu us\n", import_us);
+
+	hdestroy_r(&htab);
+	return 0;
+}
+
+ENV_TEST(env_test_htab_bench, 0);
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Unit tests for crc32 and crc32c functions
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <rand.h>
+#include <time.h>
+#include <linux/math64.h>
+#include <linux/sizes.h>
+#include <u-boot/crc.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+#define TEST_CRC32_SIZE		1024
+#define TEST_CRC32_BENCH_SIZE	SZ_1M
+
+/* Bit-at-a-time reference for the reflected polynomial @poly */
+static u32 lib_test_crc32_ref(u32 poly, u32 crc, const u8 *buf, uint len)
+{
+	int k;
+
+	crc = ~crc;
+	while (len--) {
+		crc ^= *buf++;
+		for (k = 0; k < 8; k++)
+			crc = crc & 1 ? (crc >> 1) ^ poly : crc >> 1;
+	}
+
+	return ~crc;
+}
+
+static int lib_test_crc32_vectors(struct unit_test_state *uts)
+{
+	const u8 *check = (const u8 *)"123456789";
+
+	ut_asserteq(0, crc32(0, check, 0));
+	ut_asserteq(0xcbf43926, crc32(0, check, 9));
+	/* Split anywhere, the result must be the same */
+	ut_asserteq(0xcbf43926, crc32(crc32(0, check, 5), check + 5, 4));
+#ifdef CONFIG_CRC32C
+	ut_asserteq(0xe3069283, ~crc32c(~0U, check, 9));
+	ut_asserteq(0xe3069283, ~crc32c(crc32c(~0U, check, 3), check + 3, 6));
+#endif
+
+	return 0;
+}
+LIB_TEST(lib_test_crc32_vectors, 0);
+
+/*
+ * Check the selected implementation against the reference for every length
+ * up to a few words, at every alignment of the start and end of the buffer
+ */
+static int lib_test_crc32_backend(struct unit_test_state *uts)
+{
+	u8 *buf;
+	int i, offset, len;
+
+	buf = malloc(TEST_CRC32_SIZE + 8);
+	ut_assertnonnull(buf);
+	for (i = 0; i < TEST_CRC32_SIZE + 8; i++)
+		buf[i] = rand();
+
+	for (offset = 0; offset < 8; offset++) {
+		for (len = 0; len <= 40; len++)
+			ut_asserteq(lib_test_crc32_ref(0xedb88320, 0,
+						       buf + offset, len),
+				    crc32(0, buf + offset, len));
+		ut_asserteq(lib_test_crc32_ref(0xedb88320, 0, buf + offset,
+					       TEST_CRC32_SIZE),
+			    crc32(0, buf + offset, TEST_CRC32_SIZE));
+#ifdef CONFIG_CRC32C
+		for (len = 0; len <= 40; len++)
+			ut_asserteq(lib_test_crc32_ref(0x82f63b78, 0,
+						       buf + offset, len),
+				    ~crc32c(~0U, buf + offset, len));
+		ut_asserteq(lib_test_crc32_ref(0x82f63b78, 0, buf + offset,
+					       TEST_CRC32_SIZE),
+			    ~crc32c(~0U, buf + offset, TEST_CRC32_SIZE));
+#endif
+	}
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_crc32_backend, 0);
+
+static void lib_test_crc32_report(const char *name, ulong us)
+{
+	us = max(us, 1UL);
+	printf("%-7s %lu us, %llu KiB/s\n", name, us,
+	       div_u64((u64)TEST_CRC32_BENCH_SIZE * 1000000 / 1024, us));
+}
+
+/* Report the throughput of the selected crc32 and crc32c implementations */
+static int lib_test_crc32_bench(struct unit_test_state *uts)
+{
+	ulong start;
+	u8 *buf;
+
+	buf = malloc(TEST_CRC32_BENCH_SIZE);
+	ut_assertnonnull(buf);
+	memset(buf, 0x5a, TEST_CRC32_BENCH_SIZE);
+
+	start = timer_get_us();
+	crc32(0, buf, TEST_CRC32_BENCH_SIZE);
+	lib_test_crc32_report("crc32:", timer_get_us() - start);
+#ifdef CONFIG_CRC32C
+	start = timer_get_us();
+	crc32c(~0U, buf, TEST_CRC32_BENCH_SIZE);
+	lib_test_crc32_report("crc32c:", timer_get_us() - start);
+#endif
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_crc32_bench, 0);
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Unit tests for sha256 functions
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <rand.h>
+#include <time.h>
+#include <linux/math64.h>
+#include <linux/sizes.h>
+#include <u-boot/sha256.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+#define TEST_SHA256_BLOCKS	64
+#define TEST_SHA256_BENCH_SIZE	SZ_1M
+
+struct test_sha256_s {
+	const char *input;
+	unsigned int repeat;
+	u8 digest[SHA256_SUM_LEN];
+};
+
+/* Vectors from FIPS 180-2 and the NIST examples */
+static struct test_sha256_s test_sha256[] = {
+	{ "", 1,
+	  { 0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14,
+	    0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+	    0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c,
+	    0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55 } },
+	{ "abc", 1,
+	  { 0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+	    0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+	    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+	    0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad } },
+	{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+	  { 0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8,
+	    0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+	    0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+	    0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1 } },
+	{ "a", 1000000,
+	  { 0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92,
+	    0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+	    0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e,
+	    0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0 } },
+};
+
+static int lib_test_sha256_vectors(struct unit_test_state *uts)
+{
+	u8 digest[SHA256_SUM_LEN];
+	sha256_context ctx;
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(test_sha256); i++) {
+		struct test_sha256_s *test = &test_sha256[i];
+
+		sha256_starts(&ctx);
+		for (j = 0; j < test->repeat; j++)
+			sha256_update(&ctx, (const u8 *)test->input,
+				      strlen(test->input));
+		sha256_finish(&ctx, digest);
+		ut_asserteq_mem(test->digest, digest, SHA256_SUM_LEN);
+	}
+
+	return 0;
+}
+LIB_TEST(lib_test_sha256_vectors, 0);
+
+/*
+ * Check that the selected block transform matches the generic one, at both
+ * aligned and unaligned offsets
+ */
+static int lib_test_sha256_backend(struct unit_test_state *uts)
+{
+	sha256_context ref, ctx;
+	u8 *buf;
+	int i, offset;
+
+	buf = malloc(TEST_SHA256_BLOCKS * 64 + 1);
+	ut_assertnonnull(buf);
+	for (i = 0; i < TEST_SHA256_BLOCKS * 64 + 1; i++)
+		buf[i] = rand();
+
+	for (offset = 0; offset < 2; offset++) {
+		for (i = 1; i <= TEST_SHA256_BLOCKS; i *= 2) {
+			sha256_starts(&ref);
+			sha256_starts(&ctx);
+			sha256_process_generic(&ref, buf + offset, i);
+			sha256_process(&ctx, buf + offset, i);
+			ut_asserteq_mem(ref.state, ctx.state,
+					sizeof(ref.state));
+		}
+	}
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_sha256_backend, 0);
+
+static ulong lib_test_sha256_time(void (*process)(sha256_context *,
+						  const u8 *, unsigned int),
+				  const u8 *buf)
+{
+	sha256_context ctx;
+	ulong start;
+
+	sha256_starts(&ctx);
+	start = timer_get_us();
+	process(&ctx, buf, TEST_SHA256_BENCH_SIZE / 64);
+
+	return max(timer_get_us() - start, 1UL);
+}
+
+/* Report the throughput of the generic and the selected block transform */
+static int lib_test_sha256_bench(struct unit_test_state *uts)
+{
+	ulong generic_us, selected_us;
+	u8 *buf;
+
+	buf = malloc(TEST_SHA256_BENCH_SIZE);
+	ut_assertnonnull(buf);
+	memset(buf, 0x5a, TEST_SHA256_BENCH_SIZE);
+
+	generic_us = lib_test_sha256_time(sha256_process_generic, buf);
+	selected_us = lib_test_sha256_time(sha256_process, buf);
+	free(buf);
+
+	printf("sha256 generic:  %lu us, %llu KiB/s\n", generic_us,
+	       div_u64((u64)TEST_SHA256_BENCH_SIZE * 1000000 / 1024,
+		       generic_us));
+	printf("sha256 selected: %lu us, %llu KiB/s\n", selected_us,
+	       div_u64((u64)TEST_SHA256_BENCH_SIZE * 1000000 / 1024,
+		       selected_us));
+
+	return 0;
+}
+LIB_TEST(lib_test_sha256_bench, 0);
@@ -451,6 +451,11 @@ static int fit_extract_data(struct image_tool_params *params, const char *fname)
 	int align_size;
 
 	align_size = params->bl_len ? params->bl_len : 4;
+	if (params->bl_len && params->external_offset % align_size) {
+		fprintf(stderr, "%s: External position %x is not aligned to %x\n",
+			params->cmdname, params->external_offset, align_size);
+		return -EINVAL;
+	}
 	fd = mmap_fdt(params->cmdname, fname, 0, &fdt, &sbuf, false, false);
 	if (fd < 0)
 		return -EIO;
@@ -182,7 +182,8 @@ static void process_args(int argc, char **argv)
 			break;
 		case 'B':
 			params.bl_len = strtoull(optarg, &ptr, 16);
-			if (*ptr) {
+			if (*ptr || params.bl_len <= 0 ||
+			    (params.bl_len & (params.bl_len - 1))) {
 				fprintf(stderr, "%s: invalid block length %s\n",
 					params.cmdname, optarg);
 				exit(EXIT_FAILURE);